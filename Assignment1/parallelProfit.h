@@ -0,0 +1,200 @@
+#ifndef PARALLEL_PROFIT_H
+#define PARALLEL_PROFIT_H
+
+#include <thread>
+#include <vector>
+
+//Summary of a range of days that can be merged with the summary of the range right after it.
+//The days are 0-indexed positions in the whole series, and the sums are relative to the start of the range.
+typedef struct {
+    long long total;
+    long long minPrefix;
+    long long minPrefixDay;
+    long long maxPrefix;
+    long long maxPrefixDay;
+    //The best buy/sell pair inside the range, only valid if the range has at least two days.
+    bool hasPair;
+    long long bestProfit;
+    long long bestBuy;
+    long long bestSell;
+} ProfitSummary;
+
+//Method to check if a buy/sell pair is better than the current best pair.
+//On equal profit the earliest buy day wins, and then the earliest sell day, to match the sequential scan.
+inline bool isBetterPair(long long profit, long long buy, long long sell, const ProfitSummary& current) {
+    if (!current.hasPair || profit > current.bestProfit) {
+        return true;
+    }
+
+    if (profit < current.bestProfit) {
+        return false;
+    }
+
+    return buy < current.bestBuy || (buy == current.bestBuy && sell < current.bestSell);
+}
+
+//Method to summarize the days [first, first + n) in a single pass.
+template <typename Delta>
+ProfitSummary summarizeDeltas(const Delta* deltas, long long first, long long n) {
+    ProfitSummary summary;
+    long long prefix = 0;
+
+    summary.minPrefix = 0;
+    summary.minPrefixDay = first;
+    summary.maxPrefix = 0;
+    summary.maxPrefixDay = first;
+    summary.hasPair = false;
+    summary.bestProfit = 0;
+    summary.bestBuy = 0;
+    summary.bestSell = 0;
+
+    for (long long i = 0; i < n; i++) {
+        prefix += deltas[first + i];
+
+        if (i == 0) {
+            summary.minPrefix = prefix;
+            summary.minPrefixDay = first;
+            summary.maxPrefix = prefix;
+            summary.maxPrefixDay = first;
+            continue;
+        }
+
+        //Selling today after buying on the day with the lowest value so far in the range.
+        long long profit = prefix - summary.minPrefix;
+
+        if (!summary.hasPair || profit > summary.bestProfit) {
+            summary.hasPair = true;
+            summary.bestProfit = profit;
+            summary.bestBuy = summary.minPrefixDay;
+            summary.bestSell = first + i;
+        }
+
+        //Only strictly better values move the days, so the earliest day is kept on ties.
+        if (prefix < summary.minPrefix) {
+            summary.minPrefix = prefix;
+            summary.minPrefixDay = first + i;
+        }
+
+        if (prefix > summary.maxPrefix) {
+            summary.maxPrefix = prefix;
+            summary.maxPrefixDay = first + i;
+        }
+    }
+
+    summary.total = prefix;
+    return summary;
+}
+
+//Method to merge the summary of a range with the summary of the range directly after it.
+inline ProfitSummary mergeSummaries(const ProfitSummary& left, const ProfitSummary& right) {
+    ProfitSummary merged;
+
+    merged.total = left.total + right.total;
+
+    if (left.minPrefix <= left.total + right.minPrefix) {
+        merged.minPrefix = left.minPrefix;
+        merged.minPrefixDay = left.minPrefixDay;
+    } else {
+        merged.minPrefix = left.total + right.minPrefix;
+        merged.minPrefixDay = right.minPrefixDay;
+    }
+
+    if (left.maxPrefix >= left.total + right.maxPrefix) {
+        merged.maxPrefix = left.maxPrefix;
+        merged.maxPrefixDay = left.maxPrefixDay;
+    } else {
+        merged.maxPrefix = left.total + right.maxPrefix;
+        merged.maxPrefixDay = right.maxPrefixDay;
+    }
+
+    //The best pair is either inside the left range, inside the right range, or buys in the left range
+    //and sells in the right range.
+    merged.hasPair = false;
+    merged.bestProfit = 0;
+    merged.bestBuy = 0;
+    merged.bestSell = 0;
+
+    if (left.hasPair) {
+        merged.hasPair = true;
+        merged.bestProfit = left.bestProfit;
+        merged.bestBuy = left.bestBuy;
+        merged.bestSell = left.bestSell;
+    }
+
+    long long crossProfit = left.total + right.maxPrefix - left.minPrefix;
+
+    if (isBetterPair(crossProfit, left.minPrefixDay, right.maxPrefixDay, merged)) {
+        merged.hasPair = true;
+        merged.bestProfit = crossProfit;
+        merged.bestBuy = left.minPrefixDay;
+        merged.bestSell = right.maxPrefixDay;
+    }
+
+    if (right.hasPair && isBetterPair(right.bestProfit, right.bestBuy, right.bestSell, merged)) {
+        merged.bestProfit = right.bestProfit;
+        merged.bestBuy = right.bestBuy;
+        merged.bestSell = right.bestSell;
+    }
+
+    return merged;
+}
+
+//Method to find the most profitable days to buy and sell by splitting the days into one chunk per thread.
+//Each thread summarizes its own chunk, and the summaries are merged pairwise in a tree.
+//The answer is read with profitOf, buyDayOf and sellDayOf.
+template <typename Delta>
+ProfitSummary parallelMaxProfit(const Delta* deltas, long long n, int threadCount) {
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+
+    if (threadCount > n) {
+        threadCount = n > 0 ? (int) n : 1;
+    }
+
+    std::vector<ProfitSummary> summaries(threadCount);
+    std::vector<std::thread> threads;
+    long long chunkSize = n / threadCount;
+    long long remainder = n % threadCount;
+    long long first = 0;
+
+    for (int t = 0; t < threadCount; t++) {
+        long long size = chunkSize + (t < remainder ? 1 : 0);
+
+        threads.emplace_back([&summaries, deltas, t, first, size]() {
+            summaries[t] = summarizeDeltas(deltas, first, size);
+        });
+
+        first += size;
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    //Merging neighbouring summaries until only one is left.
+    for (int step = 1; step < threadCount; step *= 2) {
+        for (int t = 0; t + step < threadCount; t += 2 * step) {
+            summaries[t] = mergeSummaries(summaries[t], summaries[t + step]);
+        }
+    }
+
+    return summaries[0];
+}
+
+//Method to get the highest possible profit from a summary of the whole series.
+inline long long profitOf(const ProfitSummary& summary) {
+    return summary.hasPair && summary.bestProfit > 0 ? summary.bestProfit : 0;
+}
+
+//Method to get the day to buy on (1-indexed, 0 if there is no profitable day) from a summary of the whole series.
+inline long long buyDayOf(const ProfitSummary& summary) {
+    return profitOf(summary) > 0 ? summary.bestBuy + 1 : 0;
+}
+
+//Method to get the day to sell on (1-indexed, 0 if there is no profitable day) from a summary of the whole series.
+inline long long sellDayOf(const ProfitSummary& summary) {
+    return profitOf(summary) > 0 ? summary.bestSell + 1 : 0;
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef PRICE_SERIES_H
+#define PRICE_SERIES_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//Binary format for a series of daily changes: a 16 byte header without padding, followed by the packed changes.
+//Values are stored in the byte order of the host, since the file is mapped and read as it is. That is little-endian on
+//x86 and ARM, and a file written there is rejected on a big-endian host, where the version does not match.
+#define PRICE_SERIES_MAGIC "PRCS"
+#define PRICE_SERIES_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    //Number of bytes per change, 2 (int16_t) or 4 (int32_t).
+    uint16_t width;
+    uint64_t count;
+} PriceSeriesHeader;
+
+static_assert(sizeof(PriceSeriesHeader) == 16, "PriceSeriesHeader must not have padding");
+
+//Method to write a series of daily changes to a file, using width bytes per change.
+//Returns false if the file could not be written or a change does not fit in the width.
+inline bool writePriceSeries(const char* filename, const int* deltas, long long n, int width) {
+    if (width != 2 && width != 4) {
+        return false;
+    }
+
+    FILE* file = fopen(filename, "wb");
+
+    if (!file) {
+        return false;
+    }
+
+    PriceSeriesHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PRICE_SERIES_MAGIC, 4);
+    header.version = PRICE_SERIES_VERSION;
+    header.width = width;
+    header.count = n;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (long long i = 0; ok && i < n; i++) {
+        if (width == 2) {
+            int16_t value = (int16_t) deltas[i];
+            ok = value == deltas[i] && fwrite(&value, sizeof(value), 1, file) == 1;
+        } else {
+            int32_t value = deltas[i];
+            ok = fwrite(&value, sizeof(value), 1, file) == 1;
+        }
+    }
+
+    return fclose(file) == 0 && ok;
+}
+
+//A series of daily changes mapped directly from a file, without copying or parsing the changes.
+class PriceSeries {
+    void* mapping;
+    size_t mappingSize;
+    const PriceSeriesHeader* header;
+
+    public:
+    PriceSeries() : mapping(NULL), mappingSize(0), header(NULL) {}
+
+    ~PriceSeries() {
+        close();
+    }
+
+    PriceSeries(const PriceSeries&) = delete;
+    PriceSeries& operator=(const PriceSeries&) = delete;
+
+    //Method to map a file. Returns false if the file can not be mapped or is not a valid series.
+    bool open(const char* filename) {
+        close();
+
+        int fd = ::open(filename, O_RDONLY);
+
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(PriceSeriesHeader)) {
+            ::close(fd);
+            return false;
+        }
+
+        void* address = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (address == MAP_FAILED) {
+            return false;
+        }
+
+        this->mapping = address;
+        this->mappingSize = info.st_size;
+        this->header = (const PriceSeriesHeader*) address;
+
+        //Checking that the header is valid and that the file holds all the changes it promises.
+        bool valid = memcmp(this->header->magic, PRICE_SERIES_MAGIC, 4) == 0
+            && this->header->version == PRICE_SERIES_VERSION
+            && (this->header->width == 2 || this->header->width == 4)
+            && this->header->count <= (this->mappingSize - sizeof(PriceSeriesHeader)) / this->header->width;
+
+        if (!valid) {
+            close();
+            return false;
+        }
+
+        //The changes are read from start to end, so the kernel can read ahead.
+        madvise(this->mapping, this->mappingSize, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    //Method to unmap the file.
+    void close() {
+        if (this->mapping) {
+            munmap(this->mapping, this->mappingSize);
+        }
+
+        this->mapping = NULL;
+        this->mappingSize = 0;
+        this->header = NULL;
+    }
+
+    //Method to get the number of days in the series.
+    long long size() const {
+        return this->header ? (long long) this->header->count : 0;
+    }
+
+    //Method to get the number of bytes per change.
+    int width() const {
+        return this->header ? this->header->width : 0;
+    }
+
+    //Method to get the changes if they are stored as int16_t, NULL otherwise.
+    const int16_t* deltas16() const {
+        return width() == 2 ? (const int16_t*) (this->header + 1) : NULL;
+    }
+
+    //Method to get the changes if they are stored as int32_t, NULL otherwise.
+    const int32_t* deltas32() const {
+        return width() == 4 ? (const int32_t*) (this->header + 1) : NULL;
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef PROFIT_INDEX_H
+#define PROFIT_INDEX_H
+
+#include <vector>
+
+#include "parallelProfit.h"
+
+//Number of days summarized by each leaf in the index.
+#define PROFIT_INDEX_BLOCK 32
+
+//Index over a series of daily changes that finds the most profitable days to buy and sell inside any range of days.
+//The days are grouped in blocks, and level k holds the summaries of 2^k blocks in a row (a segment tree stored level by level).
+//A query merges O(log n) summaries and scans at most two partial blocks at the ends of the range.
+//New days can be appended at any time, and only the summaries of blocks that become complete are added.
+class ProfitIndex {
+    std::vector<int> deltas;
+    std::vector<std::vector<ProfitSummary>> levels;
+
+    //Method to add the summary of a completed block, and the summaries of the larger ranges it completes.
+    void addBlock(long long block) {
+        ProfitSummary summary = summarizeDeltas(this->deltas.data(), block * PROFIT_INDEX_BLOCK, PROFIT_INDEX_BLOCK);
+
+        for (int level = 0;; level++) {
+            if ((int) this->levels.size() == level) {
+                this->levels.push_back(std::vector<ProfitSummary>());
+            }
+
+            this->levels[level].push_back(summary);
+
+            //A range at the next level is only complete when this summary is the right half of it.
+            long long position = (long long) this->levels[level].size() - 1;
+
+            if (position % 2 == 0) {
+                break;
+            }
+
+            summary = mergeSummaries(this->levels[level][position - 1], summary);
+        }
+    }
+
+    //Method to add a summary to the result of a query, where the days are merged from left to right.
+    static void appendSummary(ProfitSummary& result, bool& hasResult, const ProfitSummary& summary) {
+        result = hasResult ? mergeSummaries(result, summary) : summary;
+        hasResult = true;
+    }
+
+    public:
+    ProfitIndex() {}
+
+    ProfitIndex(const int* deltas, long long n) {
+        this->deltas.reserve(n);
+
+        for (long long i = 0; i < n; i++) {
+            append(deltas[i]);
+        }
+    }
+
+    //Method to add the change in value for the next day.
+    void append(int delta) {
+        this->deltas.push_back(delta);
+
+        if (this->deltas.size() % PROFIT_INDEX_BLOCK == 0) {
+            addBlock((long long) this->deltas.size() / PROFIT_INDEX_BLOCK - 1);
+        }
+    }
+
+    //Method to get the number of days in the index.
+    long long size() const {
+        return (long long) this->deltas.size();
+    }
+
+    //Method to find the most profitable days to buy and sell when both days are in [firstDay, lastDay] (1-indexed, inclusive).
+    //The answer is read with profitOf, buyDayOf and sellDayOf.
+    ProfitSummary query(long long firstDay, long long lastDay) const {
+        long long low = firstDay - 1;
+        long long high = lastDay;
+
+        if (low < 0) {
+            low = 0;
+        }
+
+        if (high > size()) {
+            high = size();
+        }
+
+        if (high <= low) {
+            return summarizeDeltas(this->deltas.data(), 0, 0);
+        }
+
+        long long firstBlock = (low + PROFIT_INDEX_BLOCK - 1) / PROFIT_INDEX_BLOCK;
+        long long lastBlock = high / PROFIT_INDEX_BLOCK;
+
+        //If the range does not cover a whole block, the days are simply scanned.
+        if (firstBlock >= lastBlock) {
+            return summarizeDeltas(this->deltas.data(), low, high - low);
+        }
+
+        ProfitSummary result;
+        bool hasResult = false;
+
+        //The days before the first whole block.
+        if (low < firstBlock * PROFIT_INDEX_BLOCK) {
+            appendSummary(result, hasResult, summarizeDeltas(this->deltas.data(), low, firstBlock * PROFIT_INDEX_BLOCK - low));
+        }
+
+        //The whole blocks, using the largest aligned ranges that fit inside the query.
+        long long block = firstBlock;
+
+        while (block < lastBlock) {
+            int level = 0;
+
+            while (level + 1 < (int) this->levels.size() && block % (2LL << level) == 0 && block + (2LL << level) <= lastBlock) {
+                level++;
+            }
+
+            appendSummary(result, hasResult, this->levels[level][block >> level]);
+            block += 1LL << level;
+        }
+
+        //The days after the last whole block.
+        if (lastBlock * PROFIT_INDEX_BLOCK < high) {
+            appendSummary(result, hasResult, summarizeDeltas(this->deltas.data(), lastBlock * PROFIT_INDEX_BLOCK, high - lastBlock * PROFIT_INDEX_BLOCK));
+        }
+
+        return result;
+    }
+};
+
+#endif
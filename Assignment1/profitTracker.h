@@ -0,0 +1,76 @@
+#ifndef PROFIT_TRACKER_H
+#define PROFIT_TRACKER_H
+
+//Single pass (Kadane-style) tracker for the most profitable day to buy and the day to sell.
+//The deltas are fed one day at a time or in chunks, and only a constant amount of state is kept,
+//so the tracker can run over input of any length.
+//Gives the same maxProfit, buyDay and sellDay as the nested loop it replaced, including which days
+//are reported when several buy/sell pairs give the same profit.
+class ProfitTracker {
+    long long days;
+    long long prefixSum;
+    long long minPrefixSum;
+    long long minPrefixDay;
+    long long maxProfit;
+    long long buyDay;
+    long long sellDay;
+
+    public:
+    ProfitTracker() : days(0), prefixSum(0), minPrefixSum(0), minPrefixDay(0), maxProfit(0), buyDay(0), sellDay(0) {}
+
+    //Method to add the change in value for the next day.
+    void addDelta(int delta) {
+        this->prefixSum += delta;
+
+        //Selling today after buying on the day with the lowest value so far.
+        //The first day can only be a buy day, since there is no earlier day to buy on.
+        if (this->days > 0) {
+            long long profit = this->prefixSum - this->minPrefixSum;
+
+            if (profit > this->maxProfit) {
+                this->maxProfit = profit;
+                this->buyDay = this->minPrefixDay + 1;
+                this->sellDay = this->days + 1;
+            }
+        }
+
+        //Only a strictly lower value moves the buy day, so the earliest day is kept on ties.
+        if (this->days == 0 || this->prefixSum < this->minPrefixSum) {
+            this->minPrefixSum = this->prefixSum;
+            this->minPrefixDay = this->days;
+        }
+
+        this->days++;
+    }
+
+    //Method to add the changes in value for several days in a row.
+    //The changes can be stored in any integer type, for example the int16_t changes of a mapped PriceSeries.
+    template <typename Delta>
+    void addDeltas(const Delta* deltas, long long n) {
+        for (long long i = 0; i < n; i++) {
+            addDelta(deltas[i]);
+        }
+    }
+
+    //Method to get the highest possible profit of the days added so far.
+    long long getMaxProfit() const {
+        return this->maxProfit;
+    }
+
+    //Method to get the day to buy on (1-indexed, 0 if there is no profitable day).
+    long long getBuyDay() const {
+        return this->buyDay;
+    }
+
+    //Method to get the day to sell on (1-indexed, 0 if there is no profitable day).
+    long long getSellDay() const {
+        return this->sellDay;
+    }
+
+    //Method to get the number of days added so far.
+    long long getDays() const {
+        return this->days;
+    }
+};
+
+#endif
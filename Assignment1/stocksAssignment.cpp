@@ -1,15 +1,59 @@
 #include <chrono>
 #include <iostream>
 #include <stdlib.h>
+#include <string.h>
+
+#include "profitTracker.h"
+#include "parallelProfit.h"
+#include "profitIndex.h"
+#include "priceSeries.h"
 
 #define length 10000
 
+//Method to find the most profitable days in a series mapped from a binary file, without copying the series.
+template <typename Delta>
+void findProfitInSeries(const Delta* deltas, long long n) {
+    auto start = std::chrono::high_resolution_clock::now();
+    ProfitTracker tracker;
+    tracker.addDeltas(deltas, n);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto timeUsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "The highest possible profit over " << n << " days is " << tracker.getMaxProfit() << std::endl;
+    std::cout << "To achieve this profit, buy on day " << tracker.getBuyDay() << " and sell on day " << tracker.getSellDay() << std::endl;
+    std::cout << "Time used to calculate: " << timeUsed.count() << " µs" << std::endl;
+
+    int threadCount = std::thread::hardware_concurrency();
+    start = std::chrono::high_resolution_clock::now();
+    ProfitSummary summary = parallelMaxProfit(deltas, n, threadCount);
+    end = std::chrono::high_resolution_clock::now();
+    auto timeUsedParallel = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "\nThe highest possible profit using " << threadCount << " threads is " << profitOf(summary) << std::endl;
+    std::cout << "To achieve this profit, buy on day " << buyDayOf(summary) << " and sell on day " << sellDayOf(summary) << std::endl;
+    std::cout << "Time used to calculate: " << timeUsedParallel.count() << " µs" << std::endl;
+}
+
 int main (int argc, char *argv[]) {
+    //Running directly over a binary series file if one is given (see priceSeries.h for the format).
+    if (argc == 2) {
+        PriceSeries series;
+
+        if (!series.open(argv[1])) {
+            printf("Could not read the series in %s.\n", argv[1]);
+            exit(1);
+        }
+
+        if (series.width() == 2) {
+            findProfitInSeries(series.deltas16(), series.size());
+        } else {
+            findProfitInSeries(series.deltas32(), series.size());
+        }
+
+        return 0;
+    }
     
-    int profit;
-    int maxProfit = 0;
-    int buyDay = 0;
-    int sellDay = 0;
+    ProfitTracker tracker;
     int stocksDaily[length];
     
     //Populating the stocksDaily array with random values between -10 and 10.
@@ -17,32 +61,53 @@ int main (int argc, char *argv[]) {
         stocksDaily[i] = rand()%21 - 10;
     }
 
+    //Saving the random values as a binary series file if asked to, using "-o filename".
+    if (argc == 3 && strcmp(argv[1], "-o") == 0) {
+        if (!writePriceSeries(argv[2], stocksDaily, length, 2)) {
+            printf("Could not write the series to %s.\n", argv[2]);
+            exit(1);
+        }
+    }
+
     //Starting the timer for the calculations.
     auto start = std::chrono::high_resolution_clock::now();
 
-    //Finding the most profitable days to buy and sell.
-    for (int i = 0; i < length; i++) {
-        profit = 0;
-
-        for (int j = i + 1; j < length; j++) {
-            profit += stocksDaily[j];
-
-            if (profit > maxProfit) {
-                maxProfit = profit;
-                buyDay = i + 1;
-                sellDay = j + 1;
-            }
-        }
-    }
+    //Finding the most profitable days to buy and sell in a single pass over the daily changes.
+    tracker.addDeltas(stocksDaily, length);
 
     //Stopping the timer for the calculation and saving the value in the timeUsed variable.
     auto end = std::chrono::high_resolution_clock::now();
     auto timeUsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
     //Printing the results.
-    std::cout << "The highest possible profit is " << maxProfit << std::endl;
-    std::cout << "To achieve this profit, buy on day " << buyDay << " and sell on day " << sellDay <<std::endl;
+    std::cout << "The highest possible profit is " << tracker.getMaxProfit() << std::endl;
+    std::cout << "To achieve this profit, buy on day " << tracker.getBuyDay() << " and sell on day " << tracker.getSellDay() <<std::endl;
     std::cout << "Time used to calculate: " << timeUsed.count() << " µs" << std::endl;
+
+    //Finding the same days again by splitting the daily changes between all the cores.
+    int threadCount = std::thread::hardware_concurrency();
+    start = std::chrono::high_resolution_clock::now();
+    ProfitSummary summary = parallelMaxProfit(stocksDaily, length, threadCount);
+    end = std::chrono::high_resolution_clock::now();
+    auto timeUsedParallel = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "\nThe highest possible profit using " << threadCount << " threads is " << profitOf(summary) << std::endl;
+    std::cout << "To achieve this profit, buy on day " << buyDayOf(summary) << " and sell on day " << sellDayOf(summary) << std::endl;
+    std::cout << "Time used to calculate: " << timeUsedParallel.count() << " µs" << std::endl;
+
+    //Building an index once, so the most profitable days inside any range of days can be found without a full scan.
+    ProfitIndex index(stocksDaily, length);
+    long long firstDay = length / 4;
+    long long lastDay = length / 2;
+
+    start = std::chrono::high_resolution_clock::now();
+    ProfitSummary rangeSummary = index.query(firstDay, lastDay);
+    end = std::chrono::high_resolution_clock::now();
+    auto timeUsedQuery = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << "\nThe highest possible profit between day " << firstDay << " and day " << lastDay << " is " << profitOf(rangeSummary) << std::endl;
+    std::cout << "To achieve this profit, buy on day " << buyDayOf(rangeSummary) << " and sell on day " << sellDayOf(rangeSummary) << std::endl;
+    std::cout << "Time used to answer the query: " << timeUsedQuery.count() << " ns" << std::endl;
     
     //Can be run to show the daily stock values to make sure that the calculations are correct.
     //printf("\nThe daily stock values: ");
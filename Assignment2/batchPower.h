@@ -0,0 +1,93 @@
+#ifndef BATCH_POWER_H
+#define BATCH_POWER_H
+
+#include <stddef.h>
+#include <immintrin.h>
+
+#include "fastPower.h"
+
+//Finding x^n for many (x, n) pairs at once, with one pair per SIMD lane.
+//Every lane runs the same square-and-multiply ladder as power(double, long long), and a lane only multiplies
+//its result when its own exponent bit is set, so lanes with different exponents are handled by masking.
+//The multiplications and divisions happen in the same order as in the scalar version, so the results are
+//bit-identical to calling power for each pair.
+
+//Method to find the powers one pair at a time.
+inline void powerBatchScalar(const double* bases, const int* exponents, double* results, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        results[i] = power(bases[i], (long long) exponents[i]);
+    }
+}
+
+//Method to find the powers 4 pairs at a time with AVX2.
+__attribute__((target("avx2")))
+inline void powerBatchAvx2(const double* bases, const int* exponents, double* results, size_t n) {
+    const __m256d one = _mm256_set1_pd(1.);
+    const __m256i bit = _mm256_set1_epi64x(1);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i exponent = _mm_loadu_si128((const __m128i*) (exponents + i));
+        __m256d negative = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_srai_epi32(exponent, 31)));
+        //|n| as an unsigned number, so INT_MIN works, widened to one 64-bit lane per base.
+        __m256i remaining = _mm256_cvtepu32_epi64(_mm_abs_epi32(exponent));
+        __m256d x = _mm256_loadu_pd(bases + i);
+        __m256d result = one;
+
+        while (!_mm256_testz_si256(remaining, remaining)) {
+            __m256d multiply = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(remaining, bit), bit));
+            result = _mm256_blendv_pd(result, _mm256_mul_pd(result, x), multiply);
+            remaining = _mm256_srli_epi64(remaining, 1);
+            x = _mm256_mul_pd(x, x);
+        }
+
+        result = _mm256_blendv_pd(result, _mm256_div_pd(one, result), negative);
+        _mm256_storeu_pd(results + i, result);
+    }
+
+    powerBatchScalar(bases + i, exponents + i, results + i, n - i);
+}
+
+//Method to find the powers 8 pairs at a time with AVX-512, using mask registers instead of blends.
+__attribute__((target("avx512f")))
+inline void powerBatchAvx512(const double* bases, const int* exponents, double* results, size_t n) {
+    const __m512d one = _mm512_set1_pd(1.);
+    const __m512i bit = _mm512_set1_epi64(1);
+    size_t i = 0;
+
+    //The zero-masked forms with every lane selected are used for the conversions and the shift, since the plain forms
+    //pass an undefined vector to the masked builtins, which gives -Wmaybe-uninitialized warnings with GCC.
+    for (; i + 8 <= n; i += 8) {
+        __m256i exponent = _mm256_loadu_si256((const __m256i*) (exponents + i));
+        __m512i signedExponent = _mm512_maskz_cvtepi32_epi64(0xFF, exponent);
+        __mmask8 negative = _mm512_cmplt_epi64_mask(signedExponent, _mm512_setzero_si512());
+        __m512i remaining = _mm512_maskz_cvtepu32_epi64(0xFF, _mm256_abs_epi32(exponent));
+        __m512d x = _mm512_loadu_pd(bases + i);
+        __m512d result = one;
+
+        while (_mm512_test_epi64_mask(remaining, remaining)) {
+            __mmask8 multiply = _mm512_test_epi64_mask(remaining, bit);
+            result = _mm512_mask_mul_pd(result, multiply, result, x);
+            remaining = _mm512_maskz_srli_epi64(0xFF, remaining, 1);
+            x = _mm512_mul_pd(x, x);
+        }
+
+        result = _mm512_mask_div_pd(result, negative, one, result);
+        _mm512_storeu_pd(results + i, result);
+    }
+
+    powerBatchScalar(bases + i, exponents + i, results + i, n - i);
+}
+
+//Method to find x^n for n pairs, results[i] = bases[i]^exponents[i], using the widest instructions the CPU supports.
+inline void powerBatch(const double* bases, const int* exponents, double* results, size_t n) {
+    if (__builtin_cpu_supports("avx512f")) {
+        powerBatchAvx512(bases, exponents, results, n);
+    } else if (__builtin_cpu_supports("avx2")) {
+        powerBatchAvx2(bases, exponents, results, n);
+    } else {
+        powerBatchScalar(bases, exponents, results, n);
+    }
+}
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef FAST_POWER_H
+#define FAST_POWER_H
+
+#include <stdint.h>
+#include <type_traits>
+
+//Iterative versions of findxPown, using exponentiation by squaring.
+//Every method is constexpr, so powers with constant arguments are calculated at compile time.
+
+//Finding the value of x^n for any type with a multiplication, where identity is the value of x^0.
+template <typename T>
+constexpr T power(T x, unsigned long long n, T identity) {
+    T result = identity;
+
+    //Multiplying in the square x^(2^k) for every bit k that is set in n.
+    while (n > 0) {
+        if (n & 1) {
+            result = result * x;
+        }
+
+        n >>= 1;
+
+        if (n > 0) {
+            x = x * x;
+        }
+    }
+
+    return result;
+}
+
+//Finding the value of x^n for numbers, where negative exponents give 1 / x^|n| for floating point numbers.
+template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+constexpr T power(T x, long long n) {
+    if (n < 0) {
+        if (std::is_floating_point<T>::value) {
+            return T(1) / power(x, 0ULL - (unsigned long long) n, T(1));
+        }
+
+        //Only 1 and -1 have integer inverses.
+        return x == T(1) ? T(1) : (x == T(-1) ? (n % 2 ? T(-1) : T(1)) : T(0));
+    }
+
+    return power(x, (unsigned long long) n, T(1));
+}
+
+//Finding the value of x^n for integers. Returns false if the value does not fit in the type, and result is then undefined.
+template <typename T>
+constexpr bool checkedPower(T x, unsigned long long n, T& result) {
+    static_assert(std::is_integral<T>::value, "checkedPower is only for integers.");
+
+    result = 1;
+    bool squareOverflowed = false;
+
+    while (n > 0) {
+        if (n & 1) {
+            //The square is only needed if its bit is set, so an overflow in it only counts here.
+            if (squareOverflowed || __builtin_mul_overflow(result, x, &result)) {
+                return false;
+            }
+        }
+
+        n >>= 1;
+
+        if (n > 0 && !squareOverflowed) {
+            squareOverflowed = __builtin_mul_overflow(x, x, &x);
+        }
+    }
+
+    return true;
+}
+
+//Modular arithmetic for an odd modulus using Montgomery reduction, which replaces the division in
+//(a * b) % modulus with multiplications and a shift.
+class Montgomery {
+    uint64_t modulus;
+    //-modulus^-1 mod 2^64.
+    uint64_t negativeInverse;
+    //2^128 mod modulus, used to convert numbers to Montgomery form.
+    uint64_t r2;
+
+    public:
+    constexpr Montgomery(uint64_t modulus) : modulus(modulus), negativeInverse(0), r2(0) {
+        //Newton's iteration doubles the number of correct bits of the inverse each step (1 -> 64 bits).
+        uint64_t inverse = modulus;
+
+        for (int i = 0; i < 6; i++) {
+            inverse *= 2 - modulus * inverse;
+        }
+
+        this->negativeInverse = 0 - inverse;
+
+        unsigned __int128 r = ((unsigned __int128) 1 << 64) % modulus;
+        this->r2 = (uint64_t) ((r * r) % modulus);
+    }
+
+    //Method to reduce t < modulus * 2^64 to t * 2^-64 mod modulus.
+    constexpr uint64_t reduce(unsigned __int128 t) const {
+        uint64_t m = (uint64_t) t * this->negativeInverse;
+        unsigned __int128 sum = t + (unsigned __int128) m * this->modulus;
+        //The sum can be up to 2^65 * modulus, so the top bit is kept before the shift.
+        bool carry = sum < t;
+        unsigned __int128 reduced = (sum >> 64) + ((unsigned __int128) carry << 64);
+
+        return (uint64_t) (reduced >= this->modulus ? reduced - this->modulus : reduced);
+    }
+
+    //Method to multiply two numbers in Montgomery form.
+    constexpr uint64_t multiply(uint64_t a, uint64_t b) const {
+        return reduce((unsigned __int128) a * b);
+    }
+
+    //Method to convert a number to Montgomery form.
+    constexpr uint64_t toMontgomery(uint64_t a) const {
+        return multiply(a % this->modulus, this->r2);
+    }
+
+    //Method to convert a number from Montgomery form.
+    constexpr uint64_t fromMontgomery(uint64_t a) const {
+        return reduce(a);
+    }
+
+    //Finding the value of x^n mod modulus.
+    constexpr uint64_t power(uint64_t x, unsigned long long n) const {
+        uint64_t result = toMontgomery(1);
+        x = toMontgomery(x);
+
+        while (n > 0) {
+            if (n & 1) {
+                result = multiply(result, x);
+            }
+
+            n >>= 1;
+
+            if (n > 0) {
+                x = multiply(x, x);
+            }
+        }
+
+        return fromMontgomery(result);
+    }
+};
+
+//Finding the value of x^n mod modulus. Uses Montgomery reduction for odd moduli, and 128-bit division otherwise.
+constexpr uint64_t modPower(uint64_t x, unsigned long long n, uint64_t modulus) {
+    if (modulus == 1) {
+        return 0;
+    }
+
+    if (modulus & 1) {
+        return Montgomery(modulus).power(x, n);
+    }
+
+    uint64_t result = 1;
+    x %= modulus;
+
+    while (n > 0) {
+        if (n & 1) {
+            result = (uint64_t) ((unsigned __int128) result * x % modulus);
+        }
+
+        n >>= 1;
+
+        if (n > 0) {
+            x = (uint64_t) ((unsigned __int128) x * x % modulus);
+        }
+    }
+
+    return result;
+}
+
+//Small square matrix with a fixed size, for example for the powers used to step linear recurrences.
+template <typename T, int N>
+struct Matrix {
+    T values[N][N];
+
+    //Method to create the identity matrix.
+    static constexpr Matrix identity() {
+        Matrix res = {};
+
+        for (int i = 0; i < N; i++) {
+            res.values[i][i] = T(1);
+        }
+
+        return res;
+    }
+
+    //Method to multiply a and b and store the product in res, which may be a or b.
+    //The product is built in a local array and copied element by element, since copying it as a whole struct
+    //makes the compiler mix narrow stores and wide loads that can not be forwarded.
+    static constexpr void multiply(Matrix& res, const Matrix& a, const Matrix& b) {
+        T product[N][N] = {};
+
+        //Each element is summed in a local variable, so it can stay in a register.
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                T sum = T(0);
+
+                for (int k = 0; k < N; k++) {
+                    sum += a.values[i][k] * b.values[k][j];
+                }
+
+                product[i][j] = sum;
+            }
+        }
+
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                res.values[i][j] = product[i][j];
+            }
+        }
+    }
+
+    constexpr Matrix operator*(const Matrix& other) const {
+        Matrix res = {};
+        multiply(res, *this, other);
+        return res;
+    }
+};
+
+//Finding the value of m^n for a matrix, multiplying in place instead of through operator*.
+template <typename T, int N>
+constexpr Matrix<T, N> power(Matrix<T, N> m, unsigned long long n) {
+    Matrix<T, N> result = Matrix<T, N>::identity();
+
+    while (n > 0) {
+        if (n & 1) {
+            Matrix<T, N>::multiply(result, result, m);
+        }
+
+        n >>= 1;
+
+        if (n > 0) {
+            Matrix<T, N>::multiply(m, m, m);
+        }
+    }
+
+    return result;
+}
+
+#endif
@@ -0,0 +1,130 @@
+#include <iostream>
+#include <stdlib.h>
+#include <chrono>
+#include <string.h>
+#include <vector>
+
+#include "../Benchmark/benchmark.h"
+#include "fastPower.h"
+#include "batchPower.h"
+
+#define BATCH_SIZE 1000000
+
+//Recursive versions in the style of findxPown in secondRecursionTask.cpp, used as the baseline for each kind of power.
+
+//Finding the value of x^n.
+double recursivePower(double x, int n) {
+    if (n == 0) {
+        return 1.;
+    }
+
+    if (n % 2 != 0) {
+        return x * recursivePower(x*x, (n-1) / 2);
+    }
+
+    return recursivePower(x*x, n / 2);
+}
+
+//Finding the value of x^n for integers (wraps around on overflow).
+unsigned long long recursiveIntegerPower(unsigned long long x, unsigned long long n) {
+    if (n == 0) {
+        return 1;
+    }
+
+    if (n % 2 != 0) {
+        return x * recursiveIntegerPower(x*x, (n-1) / 2);
+    }
+
+    return recursiveIntegerPower(x*x, n / 2);
+}
+
+//Finding the value of x^n mod modulus, using the % operator for every multiplication.
+uint64_t recursiveModPower(uint64_t x, unsigned long long n, uint64_t modulus) {
+    if (n == 0) {
+        return 1 % modulus;
+    }
+
+    uint64_t square = (uint64_t) ((unsigned __int128) x * x % modulus);
+
+    if (n % 2 != 0) {
+        return (uint64_t) ((unsigned __int128) x * recursiveModPower(square, (n-1) / 2, modulus) % modulus);
+    }
+
+    return recursiveModPower(square, n / 2, modulus);
+}
+
+//Finding the value of m^n for a matrix.
+Matrix<uint64_t, 2> recursiveMatrixPower(const Matrix<uint64_t, 2>& m, unsigned long long n) {
+    if (n == 0) {
+        return Matrix<uint64_t, 2>::identity();
+    }
+
+    if (n % 2 != 0) {
+        return m * recursiveMatrixPower(m*m, (n-1) / 2);
+    }
+
+    return recursiveMatrixPower(m*m, n / 2);
+}
+
+//The inputs are volatile so the compiler can not calculate the powers at compile time.
+volatile double baseDouble = 1.0001;
+volatile int exponentDouble = 100000;
+volatile unsigned long long baseInteger = 3;
+volatile unsigned long long exponentInteger = 1000000007;
+//The largest power of 3 that fits in 64 bits, so the overflow check does not stop early.
+volatile unsigned long long exponentNoOverflow = 40;
+volatile uint64_t modulus = 1000000007;
+int main(int argc, char *argv[]) {
+    //Fibonacci numbers from the powers of this matrix.
+    Matrix<uint64_t, 2> fibonacci = {{{1, 1}, {1, 0}}};
+
+    //A constant exponent is calculated at compile time.
+    constexpr double folded = power(1.0001, 100000);
+    std::cout << "x^n calculated at compile time is: " << folded << std::endl;
+    std::cout << "x^n is: " << power((double) baseDouble, (long long) exponentDouble) << std::endl;
+
+    std::vector<BenchmarkResult> results;
+
+    results.push_back(runBenchmark("double, recursive", []() { doNotOptimize(recursivePower(baseDouble, exponentDouble)); }));
+    results.push_back(runBenchmark("double, iterative", []() { doNotOptimize(power((double) baseDouble, (long long) exponentDouble)); }));
+
+    results.push_back(runBenchmark("integer, recursive", []() { doNotOptimize(recursiveIntegerPower(baseInteger, exponentNoOverflow)); }));
+    results.push_back(runBenchmark("integer, iterative with overflow check", []() {
+        unsigned long long result = 0;
+        doNotOptimize(checkedPower((unsigned long long) baseInteger, exponentNoOverflow, result));
+        doNotOptimize(result);
+    }));
+
+    results.push_back(runBenchmark("modular, recursive", []() { doNotOptimize(recursiveModPower(baseInteger, exponentInteger, modulus)); }));
+    results.push_back(runBenchmark("modular, Montgomery", []() { doNotOptimize(modPower(baseInteger, exponentInteger, modulus)); }));
+
+    results.push_back(runBenchmark("2x2 matrix, recursive", [&fibonacci]() { doNotOptimize(recursiveMatrixPower(fibonacci, exponentInteger)); }));
+    results.push_back(runBenchmark("2x2 matrix, iterative", [&fibonacci]() { doNotOptimize(power(fibonacci, exponentInteger)); }));
+
+    //Finding x^n for a batch of pairs with different bases and exponents, one pair at a time and with SIMD.
+    std::vector<double> bases(BATCH_SIZE);
+    std::vector<int> exponents(BATCH_SIZE);
+    std::vector<double> scalarResults(BATCH_SIZE);
+    std::vector<double> batchResults(BATCH_SIZE);
+
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        bases[i] = 0.5 + (double) rand() / RAND_MAX;
+        exponents[i] = rand() % 2001 - 1000;
+    }
+
+    results.push_back(runBenchmark("1000000 pairs, one at a time", [&]() { powerBatchScalar(bases.data(), exponents.data(), scalarResults.data(), BATCH_SIZE); }));
+    results.push_back(runBenchmark("1000000 pairs, SIMD", [&]() { powerBatch(bases.data(), exponents.data(), batchResults.data(), BATCH_SIZE); }));
+    bool identical = memcmp(scalarResults.data(), batchResults.data(), BATCH_SIZE * sizeof(double)) == 0;
+
+    for (auto& result : results) {
+        printBenchmark(result);
+    }
+
+    std::cout << "Are the SIMD results bit-identical to the scalar results? " << identical << std::endl;
+
+    //Writing the results as JSON if a filename is given.
+    if (argc > 1 && !writeBenchmarkJson(results, argv[1])) {
+        std::cout << "Could not write the results to " << argv[1] << std::endl;
+        return 1;
+    }
+}
@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <chrono>
 
+#include "../Benchmark/benchmark.h"
+
 //Finding the value of x^n.
 double findxPown(double x, int n) {
     //Returns one if n=0.
@@ -19,20 +21,22 @@ double findxPown(double x, int n) {
 }
 
 int main(int argc, char *argv[]) {
-    auto a_second = std::chrono::duration<int>(1);
-    auto start = std::chrono::high_resolution_clock::now();
-    int counter = 0;
-
-    //Finding the number of times the findxPown algorithm can be run in a second.
-    while (std::chrono::high_resolution_clock::now() - start < a_second) {
-        findxPown(1.0001, 100000);
-        counter ++;
-    }
+    //The inputs are volatile and the result is passed to doNotOptimize, so the calls can not be removed or
+    //calculated at compile time.
+    volatile double x = 1.0001;
+    volatile int n = 100000;
 
-    //Finding the average runtime of the algorithm.
-    auto freq = std::chrono::duration<double>(1./counter);
-    auto timeUsed = std::chrono::duration_cast<std::chrono::nanoseconds>(freq);
+    //Finding the runtime of the findxPown algorithm with the shared benchmark harness.
+    BenchmarkResult result = runBenchmark("findxPown recursion by squaring, x = 1.0001, n = 100000", [&]() {
+        doNotOptimize(findxPown(x, n));
+    });
 
     std::cout << "x^n is: " << findxPown(1.0001, 100000) << std::endl;
-    std:: cout << "Time used: " << timeUsed.count() << " ns" << std::endl;
+    printBenchmark(result);
+
+    //Writing the results as JSON if a filename is given.
+    if (argc > 1 && !writeBenchmarkJson({result}, argv[1])) {
+        std::cout << "Could not write the results to " << argv[1] << std::endl;
+        return 1;
+    }
 }
\ No newline at end of file
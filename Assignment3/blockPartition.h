@@ -0,0 +1,252 @@
+#ifndef BLOCK_PARTITION_H
+#define BLOCK_PARTITION_H
+
+#include <immintrin.h>
+#include <stddef.h>
+
+#include <functional>
+#include <utility>
+
+//Partition methods without data-dependent branches, as drop-in replacements for singlePivotPartition.
+//They all move the elements smaller than the pivot to the front of the range and the rest to the back.
+//Positions are ptrdiff_t, so ranges with more than INT_MAX elements (the runs of a large external sort) work.
+
+//Number of elements classified at a time by the block partition.
+#define PARTITION_BLOCK 128
+
+//Method to move the elements of t[lo..hi) that are smaller than pivot to the front, and return the index of the
+//first element that is not. Each block of elements is classified first, and the offsets of the small elements
+//are stored in a buffer without branching (BlockQuicksort-style, Lomuto variant), before they are swapped into place.
+inline ptrdiff_t blockPartitionLessThan(int* t, ptrdiff_t lo, ptrdiff_t hi, int pivot) {
+    unsigned char offsets[PARTITION_BLOCK];
+    ptrdiff_t boundary = lo;
+
+    for (ptrdiff_t block = lo; block < hi; block += PARTITION_BLOCK) {
+        int size = hi - block < PARTITION_BLOCK ? (int) (hi - block) : PARTITION_BLOCK;
+        int count = 0;
+
+        for (int i = 0; i < size; i++) {
+            offsets[count] = (unsigned char) i;
+            count += t[block + i] < pivot;
+        }
+
+        //Everything between the boundary and each offset is at least the pivot, so the swaps keep the order of the classes.
+        for (int i = 0; i < count; i++) {
+            int k = t[boundary];
+            t[boundary] = t[block + offsets[i]];
+            t[block + offsets[i]] = k;
+            boundary++;
+        }
+    }
+
+    return boundary;
+}
+
+//Table of the AVX2 permutations that move the lanes set in a mask to the front, keeping the other lanes after them.
+struct Avx2PartitionTable {
+    int permutations[256][8];
+
+    Avx2PartitionTable() {
+        for (int m = 0; m < 256; m++) {
+            int position = 0;
+
+            for (int lane = 0; lane < 8; lane++) {
+                if (m & (1 << lane)) {
+                    this->permutations[m][position++] = lane;
+                }
+            }
+
+            for (int lane = 0; lane < 8; lane++) {
+                if (!(m & (1 << lane))) {
+                    this->permutations[m][position++] = lane;
+                }
+            }
+        }
+    }
+};
+
+//Method to get the AVX2 permutation for a mask. The table is built the first time it is used.
+inline const int* avx2PartitionPermutation(int mask) {
+    static const Avx2PartitionTable table;
+    return table.permutations[mask];
+}
+
+//The vectorized partitions first save one vector from each end of the range, which leaves room to write to at both ends.
+//Each new vector is then read from the end with the least room left, and its small elements are written to the front
+//and the rest to the back. The room at the two ends always adds up to two vectors, so the writes never overwrite
+//elements that have not been read yet. At the end, the remaining elements and the two saved vectors are written.
+
+//Method to write the lanes [0, count) of a vector that are smaller than the pivot to t[writeLeft..],
+//and the other lanes to the elements just before t[writeRight].
+__attribute__((target("avx2"), always_inline))
+inline void avx2PartitionWrite(int* t, __m256i values, int count, __m256i pivots, ptrdiff_t& writeLeft,
+                               ptrdiff_t& writeRight) {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i valid = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), lanes);
+    int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(_mm256_cmpgt_epi32(pivots, values), valid)));
+    int small = __builtin_popcount(mask);
+    __m256i permuted = _mm256_permutevar8x32_epi32(values, _mm256_loadu_si256((const __m256i*) avx2PartitionPermutation(mask)));
+
+    //After the permutation the small lanes are [0, small), the large lanes are [small, count) and the invalid lanes come last.
+    //The large lanes are stored so lane count - 1 ends up just before writeRight.
+    __m256i smallLanes = _mm256_cmpgt_epi32(_mm256_set1_epi32(small), lanes);
+    __m256i largeLanes = _mm256_andnot_si256(smallLanes, valid);
+    _mm256_maskstore_epi32(t + writeLeft, smallLanes, permuted);
+    _mm256_maskstore_epi32(t + writeRight - count, largeLanes, permuted);
+    writeLeft += small;
+    writeRight -= count - small;
+}
+
+//Method to partition t[lo..hi) like blockPartitionLessThan, 8 elements at a time with AVX2. Needs at least 16 elements.
+__attribute__((target("avx2")))
+inline ptrdiff_t avx2PartitionLessThan(int* t, ptrdiff_t lo, ptrdiff_t hi, int pivot) {
+    const __m256i pivots = _mm256_set1_epi32(pivot);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i first = _mm256_loadu_si256((const __m256i*) (t + lo));
+    __m256i last = _mm256_loadu_si256((const __m256i*) (t + hi - 8));
+    ptrdiff_t readLeft = lo + 8;
+    ptrdiff_t readRight = hi - 8;
+    ptrdiff_t writeLeft = lo;
+    ptrdiff_t writeRight = hi;
+
+    while (readRight - readLeft >= 8) {
+        __m256i values;
+
+        if (readLeft - writeLeft <= writeRight - readRight) {
+            values = _mm256_loadu_si256((const __m256i*) (t + readLeft));
+            readLeft += 8;
+        } else {
+            readRight -= 8;
+            values = _mm256_loadu_si256((const __m256i*) (t + readRight));
+        }
+
+        avx2PartitionWrite(t, values, 8, pivots, writeLeft, writeRight);
+    }
+
+    int rest = (int) (readRight - readLeft);
+    __m256i remaining = _mm256_maskload_epi32(t + readLeft, _mm256_cmpgt_epi32(_mm256_set1_epi32(rest), lanes));
+    avx2PartitionWrite(t, remaining, rest, pivots, writeLeft, writeRight);
+    avx2PartitionWrite(t, first, 8, pivots, writeLeft, writeRight);
+    avx2PartitionWrite(t, last, 8, pivots, writeLeft, writeRight);
+
+    return writeLeft;
+}
+
+//Method to write the lanes in valid of a vector that are smaller than the pivot to t[writeLeft..],
+//and the other lanes in valid to the elements just before t[writeRight].
+__attribute__((target("avx512f"), always_inline))
+inline void avx512PartitionWrite(int* t, __m512i values, __mmask16 valid, __m512i pivots, ptrdiff_t& writeLeft,
+                                 ptrdiff_t& writeRight) {
+    __mmask16 small = _mm512_mask_cmplt_epi32_mask(valid, values, pivots);
+    __mmask16 large = valid & ~small;
+    int smallCount = __builtin_popcount(small);
+    int largeCount = __builtin_popcount(large);
+
+    _mm512_mask_compressstoreu_epi32(t + writeLeft, small, values);
+    writeLeft += smallCount;
+    writeRight -= largeCount;
+    _mm512_mask_compressstoreu_epi32(t + writeRight, large, values);
+}
+
+//Method to partition t[lo..hi) like blockPartitionLessThan, 16 elements at a time with AVX-512 compress-stores.
+//Needs at least 32 elements.
+__attribute__((target("avx512f")))
+inline ptrdiff_t avx512PartitionLessThan(int* t, ptrdiff_t lo, ptrdiff_t hi, int pivot) {
+    const __m512i pivots = _mm512_set1_epi32(pivot);
+    __m512i first = _mm512_loadu_si512(t + lo);
+    __m512i last = _mm512_loadu_si512(t + hi - 16);
+    ptrdiff_t readLeft = lo + 16;
+    ptrdiff_t readRight = hi - 16;
+    ptrdiff_t writeLeft = lo;
+    ptrdiff_t writeRight = hi;
+
+    while (readRight - readLeft >= 16) {
+        __m512i values;
+
+        if (readLeft - writeLeft <= writeRight - readRight) {
+            values = _mm512_loadu_si512(t + readLeft);
+            readLeft += 16;
+        } else {
+            readRight -= 16;
+            values = _mm512_loadu_si512(t + readRight);
+        }
+
+        avx512PartitionWrite(t, values, 0xFFFF, pivots, writeLeft, writeRight);
+    }
+
+    __mmask16 rest = (__mmask16) ((1u << (readRight - readLeft)) - 1);
+    __m512i remaining = _mm512_maskz_loadu_epi32(rest, t + readLeft);
+    avx512PartitionWrite(t, remaining, rest, pivots, writeLeft, writeRight);
+    avx512PartitionWrite(t, first, 0xFFFF, pivots, writeLeft, writeRight);
+    avx512PartitionWrite(t, last, 0xFFFF, pivots, writeLeft, writeRight);
+
+    return writeLeft;
+}
+
+//Method to partition t[lo..hi) with the widest instructions the CPU supports, or the block partition for small ranges.
+inline ptrdiff_t simdPartitionLessThan(int* t, ptrdiff_t lo, ptrdiff_t hi, int pivot) {
+    static const int level = __builtin_cpu_supports("avx512f") ? 2 : (__builtin_cpu_supports("avx2") ? 1 : 0);
+
+    if (level == 2 && hi - lo >= 32) {
+        return avx512PartitionLessThan(t, lo, hi, pivot);
+    }
+
+    if (level >= 1 && hi - lo >= 16) {
+        return avx2PartitionLessThan(t, lo, hi, pivot);
+    }
+
+    return blockPartitionLessThan(t, lo, hi, pivot);
+}
+
+//Method to sort t[a], t[b] and t[c] so that t[a] <= t[b] <= t[c].
+inline void sort3(int* t, ptrdiff_t a, ptrdiff_t b, ptrdiff_t c) {
+    if (t[a] > t[b]) {
+        std::swap(t[a], t[b]);
+    }
+    if (t[b] > t[c]) {
+        std::swap(t[b], t[c]);
+        if (t[a] > t[b]) {
+            std::swap(t[a], t[b]);
+        }
+    }
+}
+
+//Method to choose a pivot for t[v..h] for the partitions below and return its position.
+//The partitions do not keep the order of the elements, so a sorted range turns into patterns where the median of three
+//is a poor pivot. Larger ranges therefore use the median of three medians of three (Tukey's ninther).
+inline ptrdiff_t choosePivot(int* t, ptrdiff_t v, ptrdiff_t h) {
+    ptrdiff_t m = v + (h - v) / 2;
+    sort3(t, v, m, h);
+
+    if (h - v < 128) {
+        return m;
+    }
+
+    sort3(t, v + 1, m - 1, h - 1);
+    sort3(t, v + 2, m + 1, h - 2);
+    sort3(t, m - 1, m, m + 1);
+    return m;
+}
+
+//Method to partition [first, last) with the block partition. Returns the position of the pivot, like singlePivotPartition,
+//so it can be passed as the partition of singlePivotQuicksort for int ranges.
+inline int* blockPartition(int* first, int* last, std::less<int>) {
+    ptrdiff_t h = last - first - 1;
+    ptrdiff_t m = choosePivot(first, 0, h);
+    std::swap(first[m], first[h]);
+    ptrdiff_t boundary = blockPartitionLessThan(first, 0, h, first[h]);
+    std::swap(first[boundary], first[h]);
+    return first + boundary;
+}
+
+//Method to partition [first, last) with SIMD instructions. Returns the position of the pivot, like singlePivotPartition.
+inline int* simdPartition(int* first, int* last, std::less<int>) {
+    ptrdiff_t h = last - first - 1;
+    ptrdiff_t m = choosePivot(first, 0, h);
+    std::swap(first[m], first[h]);
+    ptrdiff_t boundary = simdPartitionLessThan(first, 0, h, first[h]);
+    std::swap(first[boundary], first[h]);
+    return first + boundary;
+}
+
+#endif
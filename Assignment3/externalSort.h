@@ -0,0 +1,442 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "quicksort.h"
+#include "blockPartition.h"
+
+//External merge sort for files of native ints that are larger than the memory.
+//The input is read one memory budget at a time, each part is sorted with the quicksort and written to a temporary file
+//as a sorted run, and the runs are merged with a loser tree. If there are more runs than fit in the budget with
+//a reasonable buffer each, groups of runs are first merged into longer runs.
+
+//Alignment of the buffers, file offsets and sizes for O_DIRECT.
+#define EXTERNAL_SORT_ALIGNMENT 4096
+//Smallest buffer each run gets while merging. Smaller buffers would turn the merge into random reads.
+#define EXTERNAL_SORT_MIN_BUFFER (1 << 20)
+
+//Settings for an external sort.
+typedef struct {
+    //Largest number of bytes used for buffers.
+    size_t memoryBudget;
+    //Whether the files are read and written with O_DIRECT, bypassing the page cache. Filesystems that do not support it
+    //are read and written normally.
+    bool directIo;
+    //Directory for the temporary files with the sorted runs.
+    const char* tempDirectory;
+} ExternalSortOptions;
+
+inline ExternalSortOptions defaultExternalSortOptions() {
+    return ExternalSortOptions{(size_t) 256 << 20, false, "/tmp"};
+}
+
+//Method to round a number of bytes down to the alignment, but not below one aligned block.
+inline size_t alignBufferSize(size_t bytes) {
+    bytes -= bytes % EXTERNAL_SORT_ALIGNMENT;
+    return bytes < EXTERNAL_SORT_ALIGNMENT ? EXTERNAL_SORT_ALIGNMENT : bytes;
+}
+
+//Method to allocate a buffer aligned for O_DIRECT. Returns NULL if there is not enough memory.
+inline int* allocateIoBuffer(size_t bytes) {
+    void* buffer = NULL;
+    return posix_memalign(&buffer, EXTERNAL_SORT_ALIGNMENT, bytes) == 0 ? (int*) buffer : NULL;
+}
+
+//Method to open a file, with O_DIRECT if direct is set and the filesystem supports it. Returns -1 on failure.
+inline int openSortFile(const char* filename, int flags, bool direct) {
+    if (direct) {
+        int fd = open(filename, flags | O_DIRECT, 0644);
+
+        if (fd >= 0 || errno != EINVAL) {
+            return fd;
+        }
+    }
+
+    int fd = open(filename, flags, 0644);
+
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    return fd;
+}
+
+//Method to read up to bytes bytes, continuing after short reads. Returns the number of bytes read, or -1 on failure.
+inline long long readFully(int fd, void* buffer, size_t bytes) {
+    size_t done = 0;
+
+    while (done < bytes) {
+        ssize_t n = read(fd, (char*) buffer + done, bytes - done);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n < 0) {
+            return -1;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        done += n;
+    }
+
+    return (long long) done;
+}
+
+//Method to write bytes bytes. With O_DIRECT only whole aligned blocks can be written, so a smaller last part is
+//written with O_DIRECT turned off. This must therefore be the last write to the file. Returns false on failure.
+inline bool writeFully(int fd, const void* buffer, size_t bytes) {
+    int flags = fcntl(fd, F_GETFL);
+    size_t aligned = (flags & O_DIRECT) ? bytes - bytes % EXTERNAL_SORT_ALIGNMENT : bytes;
+    size_t done = 0;
+
+    while (done < bytes) {
+        if (done == aligned) {
+            fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+            aligned = bytes;
+        }
+
+        ssize_t n = write(fd, (const char*) buffer + done, aligned - done);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            fcntl(fd, F_SETFL, flags);
+            return false;
+        }
+
+        done += n;
+    }
+
+    fcntl(fd, F_SETFL, flags);
+    return true;
+}
+
+//Method to create a temporary file for a run. Returns -1 on failure, otherwise the name is stored in filename.
+inline int createRunFile(const char* directory, bool direct, std::string& filename) {
+    std::string name = std::string(directory) + "/sortrunXXXXXX";
+    std::vector<char> path(name.begin(), name.end());
+    path.push_back('\0');
+
+    int fd = mkstemp(path.data());
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    filename = path.data();
+
+    if (direct) {
+        //Not every filesystem supports O_DIRECT, and then the run is written normally.
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_DIRECT);
+    }
+
+    return fd;
+}
+
+//Method to remove the temporary files for the runs.
+inline void removeRuns(std::vector<std::string>& runs) {
+    for (const std::string& run : runs) {
+        unlink(run.c_str());
+    }
+
+    runs.clear();
+}
+
+//Reads the ints of a sorted run through a buffer.
+class RunReader {
+    int fd;
+    int* buffer;
+    size_t capacity;
+    size_t count;
+    size_t position;
+    bool failed;
+
+    public:
+    RunReader(int fd, int* buffer, size_t capacity) : fd(fd), buffer(buffer), capacity(capacity), count(0), position(0), failed(false) {}
+
+    //Method to fill the buffer with the next part of the run. Returns false if the run is finished or could not be read.
+    bool refill() {
+        long long bytes = readFully(this->fd, this->buffer, this->capacity * sizeof(int));
+
+        if (bytes < 0 || bytes % sizeof(int) != 0) {
+            this->failed = true;
+            bytes = 0;
+        }
+
+        this->count = bytes / sizeof(int);
+        this->position = 0;
+        return this->count > 0;
+    }
+
+    //Method to check if there are more ints in the run.
+    bool hasValue() const {
+        return this->position < this->count;
+    }
+
+    int value() const {
+        return this->buffer[this->position];
+    }
+
+    //Method to move to the next int in the run.
+    void advance() {
+        if (++this->position == this->count) {
+            refill();
+        }
+    }
+
+    bool hasFailed() const {
+        return this->failed;
+    }
+};
+
+//Tournament tree for a k-way merge, where every inner node holds the run that lost the comparison at that node.
+//After the smallest value is taken from the winning run, only the path from that run to the root is replayed,
+//which is log2(k) comparisons with one run each instead of comparing two children at every level.
+class LoserTree {
+    std::vector<RunReader>& runs;
+    //tree[0] is the winning run, tree[1..k-1] are the losers at the inner nodes. The run i is the leaf k + i.
+    std::vector<int> tree;
+
+    //Method to check if run a goes before run b. Finished runs go after every other run.
+    bool beats(int a, int b) const {
+        if (!this->runs[a].hasValue()) {
+            return false;
+        }
+
+        if (!this->runs[b].hasValue()) {
+            return true;
+        }
+
+        return this->runs[a].value() < this->runs[b].value();
+    }
+
+    public:
+    LoserTree(std::vector<RunReader>& runs) : runs(runs), tree(runs.size()) {
+        int k = (int) runs.size();
+        std::vector<int> winners(2 * k);
+
+        for (int i = 0; i < k; i++) {
+            winners[k + i] = i;
+        }
+
+        for (int node = k - 1; node >= 1; node--) {
+            int a = winners[2 * node];
+            int b = winners[2 * node + 1];
+            bool aWins = beats(a, b);
+            winners[node] = aWins ? a : b;
+            this->tree[node] = aWins ? b : a;
+        }
+
+        this->tree[0] = k > 1 ? winners[1] : 0;
+    }
+
+    //Method to get the run with the smallest value.
+    int winner() const {
+        return this->tree[0];
+    }
+
+    //Method to replay the games of the winning run after it has moved to its next value.
+    void replay() {
+        int k = (int) this->runs.size();
+        int winner = this->tree[0];
+
+        for (int node = (k + winner) / 2; node >= 1; node /= 2) {
+            if (beats(this->tree[node], winner)) {
+                std::swap(this->tree[node], winner);
+            }
+        }
+
+        this->tree[0] = winner;
+    }
+};
+
+//Method to merge sorted runs into the file outFd. The memory budget is split between the runs and the output.
+//Returns false if a file could not be read or written.
+inline bool mergeRuns(const std::vector<std::string>& runs, int outFd, size_t memoryBudget, bool direct) {
+    size_t bufferBytes = alignBufferSize(memoryBudget / (runs.size() + 1));
+    size_t capacity = bufferBytes / sizeof(int);
+    std::vector<int> fds;
+    std::vector<int*> buffers;
+    std::vector<RunReader> readers;
+    int* output = allocateIoBuffer(bufferBytes);
+    bool ok = output != NULL;
+
+    for (size_t i = 0; ok && i < runs.size(); i++) {
+        int fd = openSortFile(runs[i].c_str(), O_RDONLY, direct);
+        int* buffer = fd >= 0 ? allocateIoBuffer(bufferBytes) : NULL;
+
+        if (fd >= 0) {
+            fds.push_back(fd);
+        }
+
+        if (!buffer) {
+            ok = false;
+            break;
+        }
+
+        buffers.push_back(buffer);
+        readers.push_back(RunReader(fd, buffer, capacity));
+        readers.back().refill();
+    }
+
+    if (ok && !readers.empty()) {
+        LoserTree tree(readers);
+        size_t filled = 0;
+
+        for (;;) {
+            RunReader& run = readers[tree.winner()];
+
+            if (!run.hasValue()) {
+                break;
+            }
+
+            output[filled++] = run.value();
+
+            if (filled == capacity) {
+                ok = ok && writeFully(outFd, output, filled * sizeof(int));
+                filled = 0;
+            }
+
+            run.advance();
+            tree.replay();
+        }
+
+        ok = ok && writeFully(outFd, output, filled * sizeof(int));
+
+        for (RunReader& reader : readers) {
+            ok = ok && !reader.hasFailed();
+        }
+    }
+
+    for (int fd : fds) {
+        close(fd);
+    }
+
+    for (int* buffer : buffers) {
+        free(buffer);
+    }
+
+    free(output);
+    return ok;
+}
+
+//Method to sort the part of the input that fits in the budget at a time, and write each part as a run.
+//Returns false if a file could not be read or written.
+inline bool createSortedRuns(int inFd, const ExternalSortOptions& options, std::vector<std::string>& runs) {
+    size_t bufferBytes = alignBufferSize(options.memoryBudget);
+    int* buffer = allocateIoBuffer(bufferBytes);
+
+    if (!buffer) {
+        return false;
+    }
+
+    bool ok = true;
+
+    for (;;) {
+        long long bytes = readFully(inFd, buffer, bufferBytes);
+
+        if (bytes <= 0 || bytes % sizeof(int) != 0) {
+            ok = bytes == 0;
+            break;
+        }
+
+        int* last = buffer + bytes / sizeof(int);
+        singlePivotQuicksort(buffer, last, std::less<int>(), simdPartition);
+
+        std::string run;
+        int fd = createRunFile(options.tempDirectory, options.directIo, run);
+
+        if (fd < 0) {
+            ok = false;
+            break;
+        }
+
+        runs.push_back(run);
+        ok = writeFully(fd, buffer, bytes);
+        close(fd);
+
+        if (!ok) {
+            break;
+        }
+    }
+
+    free(buffer);
+    return ok;
+}
+
+//Method to sort the ints in the file input into the file output, using at most the memory budget for buffers.
+//Returns false if a file could not be read or written, or the input is not a whole number of ints.
+inline bool externalSort(const char* input, const char* output, ExternalSortOptions options = defaultExternalSortOptions()) {
+    int inFd = openSortFile(input, O_RDONLY, options.directIo);
+
+    if (inFd < 0) {
+        return false;
+    }
+
+    struct stat info;
+
+    if (fstat(inFd, &info) != 0 || info.st_size % sizeof(int) != 0) {
+        close(inFd);
+        return false;
+    }
+
+    std::vector<std::string> runs;
+    bool ok = createSortedRuns(inFd, options, runs);
+    close(inFd);
+
+    //The number of runs merged at a time, so every run and the output gets a buffer of at least EXTERNAL_SORT_MIN_BUFFER.
+    size_t fanIn = options.memoryBudget / EXTERNAL_SORT_MIN_BUFFER;
+    fanIn = fanIn < 3 ? 2 : fanIn - 1;
+
+    while (ok && runs.size() > fanIn) {
+        std::vector<std::string> merged;
+
+        for (size_t first = 0; ok && first < runs.size(); first += fanIn) {
+            std::vector<std::string> group(runs.begin() + first, runs.begin() + std::min(first + fanIn, runs.size()));
+            std::string run;
+            int fd = createRunFile(options.tempDirectory, options.directIo, run);
+
+            if (fd < 0) {
+                ok = false;
+                break;
+            }
+
+            merged.push_back(run);
+            ok = mergeRuns(group, fd, options.memoryBudget, options.directIo);
+            close(fd);
+        }
+
+        removeRuns(runs);
+        runs = merged;
+    }
+
+    if (ok) {
+        int outFd = openSortFile(output, O_WRONLY | O_CREAT | O_TRUNC, options.directIo);
+        ok = outFd >= 0 && mergeRuns(runs, outFd, options.memoryBudget, options.directIo);
+
+        if (outFd >= 0) {
+            ok = close(outFd) == 0 && ok;
+        }
+    }
+
+    removeRuns(runs);
+    return ok;
+}
+
+#endif
@@ -1,137 +1,37 @@
 #include <ctime>
 #include <iostream>
 #include <stdlib.h>
+#include <string.h>
 #include <chrono>
 #include <algorithm>
-
+#include <execution>
+#include <thread>
+#include <string>
+#include <vector>
+
+#include "../Benchmark/benchmark.h"
+#include "quicksort.h"
+#include "radixSort.h"
+#include "blockPartition.h"
+#include "externalSort.h"
+
+#ifndef SIZE
 #define SIZE 100000000
+#endif
 
-int singlePivotPartition(int* t, int v, int h);
-int median3sort(int* t, int v, int h);
-int dualPivotPartition(int* arr, int low, int high, int* lp);
-
-//Method to make elements swap places from "Algoritmer og Datastrukturer med eksempler i C og Java" by Hafting & Ljosland (2014).
-void swap(int* i, int* j) {
-    int k = *j;
-    *j = *i;
-    *i = k;
-}
+//Number of times each sorting method sorts each list, each time a fresh copy of it.
+#ifndef SORT_SAMPLES
+#define SORT_SAMPLES 5
+#endif
 
-//Quicksort method from "Algoritmer og Datastrukturer med eksempler i C og Java" by Hafting & Ljosland (2014).
+//Method to sort t[v..h] with the single pivot quicksort from quicksort.h.
 void singlePivotQuicksort(int* t, int v, int h) {
-    if (h - v > 2) {
-        int dividePos = singlePivotPartition(t, v, h);
-        singlePivotQuicksort(t, v, dividePos -1);
-        singlePivotQuicksort(t, dividePos + 1, h);
-
-    } else {
-        median3sort(t, v, h);
-    }
-}
-
-//Method to sort 3 numbers to find the median from "Algoritmer og Datastrukturer med eksempler i C og Java" by Hafting & Ljosland (2014).
-int median3sort(int* t, int v, int h) {
-    int m = (v + h) / 2;
-
-    if (t[v] > t[m]) {
-        swap(&t[v], &t[m]);
-    }
-    if (t[m] > t[h]) {
-        swap(&t[m], &t[h]);
-        if (t[v] > t[m]){
-            swap(&t[v], &t[m]);
-        }
-    }
-    
-    return m;
-}
-
-//Method to find a divisor value and place the lower values on lower indexes, and higher values on higher indexes. 
-//From "Algoritmer og Datastrukturer med eksempler i C og Java" by Hafting & Ljosland (2014).
-int singlePivotPartition(int* t, int v, int h) {
-    int iv, ih;
-    int m = median3sort(t, v, h);
-    int dv = t[m];
-    swap(&t[m], &t[h - 1]);
-
-    for (iv = v, ih = h - 1;;) {
-        while (t[++iv] < dv);
-        while (t[--ih] > dv);
-
-        if (iv >= ih) {
-            break;
-        }
-
-        swap(&t[iv], &t[ih]);
-    }
-
-    swap(&t[iv], &t[h - 1]);
-    return iv;
+    singlePivotQuicksort(t + v, t + h + 1);
 }
 
-//Method to perform a dual pivot quicksort.
-//Code retrieved from https://www.geeksforgeeks.org/dual-pivot-quicksort/ on September 9th, 2022. 
+//Method to sort arr[low..high] with the dual pivot quicksort from quicksort.h.
 void dualPivotQuicksort(int* arr, int low, int high) {
-    if (low < high) {
-        //lp means left pivot, and rp means right pivot.
-        int lp, rp;
-        rp = dualPivotPartition(arr, low, high, &lp);
-        dualPivotQuicksort(arr, low, lp - 1);
-        dualPivotQuicksort(arr, lp + 1, rp - 1);
-        dualPivotQuicksort(arr, rp + 1, high);
-    }
-}
-
-//Method to split and place the elements in the list using three different intervals.
-//Code retrieved from https://www.geeksforgeeks.org/dual-pivot-quicksort/ on September 9th, 2022.
-//Small edits implemented to compensate for weaknesses in the code.
-int dualPivotPartition(int* arr, int low, int high, int* lp) {
-    swap(&arr[low], &arr[low + (high - low) / 3]);
-    swap(&arr[high], &arr[high - (high - low) / 3]);
-
-    if (arr[low] > arr[high])
-        swap(&arr[low], &arr[high]);
-    //p is the left pivot, and q is the right pivot.
-    int j = low + 1;
-    int g = high - 1;
-    int k = low + 1;
-    int p = arr[low];
-    int q = arr[high];
-
-    while (k <= g) {
- 
-        //If elements are less than the left pivot
-        if (arr[k] < p) {
-            swap(&arr[k], &arr[j]);
-            j++;
-        }
- 
-        //If elements are greater than or equal
-        //To the right pivot
-        else if (arr[k] >= q) {
-            while (arr[g] > q && k < g)
-                g--;
-            swap(&arr[k], &arr[g]);
-            g--;
-            if (arr[k] < p) {
-                swap(&arr[k], &arr[j]);
-                j++;
-            }
-        }
-        k++;
-    }
-    j--;
-    g++;
- 
-    //Bring pivots to their appropriate positions.
-    swap(&arr[low], &arr[j]);
-    swap(&arr[high], &arr[g]);
- 
-    //Returning the indices of the pivots.
-    *lp = j; //Because we cannot return two elements
-    //From a function.
- 
-    return g;
+    dualPivotQuicksort(arr + low, arr + high + 1);
 }
 
 //Method to find the sum of the elements in an array.
@@ -157,6 +57,61 @@ bool checkOrder(int *list, int n) {
 }
 
 int main(int argc, char const *argv[]) {
+    //Writing a file of random integers for the external sort: quicksort -g file count
+    if (argc == 4 && strcmp(argv[1], "-g") == 0) {
+        long long count = atoll(argv[3]);
+        FILE* file = fopen(argv[2], "wb");
+        std::vector<int> block(1 << 20);
+        bool ok = file != NULL;
+        srand(time(NULL));
+
+        for (long long written = 0; ok && written < count; written += block.size()) {
+            size_t n = std::min((long long) block.size(), count - written);
+
+            for (size_t i = 0; i < n; i++) {
+                block[i] = rand();
+            }
+
+            ok = fwrite(block.data(), sizeof(int), n, file) == n;
+        }
+
+        if (!file || fclose(file) != 0 || !ok) {
+            std::cout << "Could not write the integers to " << argv[2] << ".\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+    //Sorting a file of integers that may be larger than the memory: quicksort -e input output [memory in MB] [-direct]
+    if (argc >= 4 && strcmp(argv[1], "-e") == 0) {
+        ExternalSortOptions options = defaultExternalSortOptions();
+
+        for (int i = 4; i < argc; i++) {
+            if (strcmp(argv[i], "-direct") == 0) {
+                options.directIo = true;
+            } else {
+                options.memoryBudget = (size_t) atoll(argv[i]) << 20;
+            }
+        }
+
+        if (getenv("TMPDIR")) {
+            options.tempDirectory = getenv("TMPDIR");
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        if (options.memoryBudget == 0 || !externalSort(argv[2], argv[3], options)) {
+            std::cout << "Could not sort " << argv[2] << " into " << argv[3] << ".\n";
+            return 1;
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Time used for external merge sort with " << (options.memoryBudget >> 20) << " MB of memory: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " µs\n";
+        return 0;
+    }
+
     //Test data for the checkSums()- and checkOrder()-methods.
     int testList1[10] = {8, 6, 3, 7, 4, 2, 6, 2, 8, 2};
     int testList2[10] = {2, 6, 4, 9, 1, 7, 4, 7, 1, 9};
@@ -205,80 +160,116 @@ int main(int argc, char const *argv[]) {
         std::cout << testList2[i] << ", ";
     }
 
-    //Initialize two different lists of random integers with a size equal to the constant SIZE.
+    //The sorting methods also work on other types. Sorting strings and key/index pairs only moves the elements,
+    //so the strings are not copied and nothing is allocated while sorting.
+    std::vector<std::string> words = {"quicksort", "dual", "pivot", "introsort", "heapsort", "radix", "block", "partition",
+        "insertion", "merge", "dual", "sort"};
+    std::vector<std::pair<long long, int>> keys;
+
+    for (int i = 0; i < 100000; i++) {
+        keys.push_back(std::make_pair(((long long) rand() << 31) ^ rand(), i));
+    }
+
+    singlePivotQuicksort(words.begin(), words.end());
+    dualPivotQuicksort(keys.begin(), keys.end(), [](const std::pair<long long, int>& a, const std::pair<long long, int>& b) {
+        return a.first < b.first;
+    });
+
+    std::cout << "\n\nSorted words: ";
+
+    for (const std::string& word : words) {
+        std::cout << word << ", ";
+    }
+
+    std::cout << "\nAre the 64-bit key/index pairs sorted by key after dual pivot quicksort? "
+              << std::is_sorted(keys.begin(), keys.end(), [](const std::pair<long long, int>& a, const std::pair<long long, int>& b) {
+                  return a.first < b.first;
+              }) << "\n";
+
+    //Initialize a list of random integers, a list of random integers with several duplicates among the elements
+    //and a list of integers that is already sorted, which is also sorted in reverse, with a size equal to the constant SIZE.
+    //Each sorting method sorts its own copy of the lists.
     srand(time(NULL));
-    int* list1 = new int[SIZE];
-    int* list2 = new int[SIZE];
+    int* randomList = new int[SIZE];
+    int* listWithDuplicates = new int[SIZE];
+    int* sortedList = new int[SIZE];
+    int* copy = new int[SIZE];
 
     for (int i = 0; i < SIZE; i++) {
-        list1[i] = rand();
-        list2[i] = rand();
+        randomList[i] = rand();
+        listWithDuplicates[i] = 50 + (rand() % 950);
+        sortedList[i] = rand();
     }
 
-    //Initialize two different lists of random integers with several duplicates among the elements.
-    int* listWithDuplicates1 = new int[SIZE];
-    int* listWithDuplicates2 = new int[SIZE];
+    std::sort(sortedList, sortedList + SIZE);
 
-    for (int i = 0; i < SIZE; i++) {
-        listWithDuplicates1[i] = 50 + (rand() % 950);
-        listWithDuplicates2[i] = 50 + (rand() % 950);
+    int threadCount = std::thread::hardware_concurrency();
+    //The reverse sorted list is made from the sorted list when it is copied, so it does not need its own array.
+    const char* listNames[4] = {"list of random integers", "list with duplicates", "list that is already sorted", "list that is sorted in reverse"};
+    int* lists[4] = {randomList, listWithDuplicates, sortedList, sortedList};
+
+    const char* methodNames[7] = {"single pivot quicksort", "dual pivot quicksort", "parallel dual pivot quicksort", "std::sort with std::execution::par", "LSD radix sort",
+        "single pivot quicksort with block partition", "single pivot quicksort with SIMD partition"};
+    std::vector<BenchmarkResult> results;
+
+    for (int l = 0; l < 4; l++) {
+        std::cout << "\n\n";
+        int sum = checkSums(lists[l], SIZE);
+
+        for (int method = 0; method < 7; method++) {
+            std::string name = methodNames[method];
+
+            if (method >= 2 && method <= 4) {
+                name += " (" + std::to_string(threadCount) + " threads)";
+            }
+
+            name += std::string(" on ") + listNames[l];
+
+            //Measure time for the sorting method on the list. Copying the list before each sort is not timed.
+            BenchmarkResult result = runBenchmarkWithSetup(name, [&]() {
+                if (l == 3) {
+                    std::reverse_copy(lists[l], lists[l] + SIZE, copy);
+                } else {
+                    std::copy(lists[l], lists[l] + SIZE, copy);
+                }
+            }, [&]() {
+                if (method == 0) {
+                    singlePivotQuicksort(copy, 0, SIZE - 1);
+                } else if (method == 1) {
+                    dualPivotQuicksort(copy, 0, SIZE - 1);
+                } else if (method == 2) {
+                    parallelDualPivotQuicksort(copy, copy + SIZE, std::less<int>(), threadCount);
+                } else if (method == 3) {
+                    std::sort(std::execution::par, copy, copy + SIZE);
+                } else if (method == 4) {
+                    radixSort(copy, 0, SIZE - 1, threadCount);
+                } else if (method == 5) {
+                    singlePivotQuicksort(copy, copy + SIZE, std::less<int>(), blockPartition);
+                } else {
+                    singlePivotQuicksort(copy, copy + SIZE, std::less<int>(), simdPartition);
+                }
+            }, longRunBenchmarkOptions(SORT_SAMPLES));
+
+            std::cout << "Time used for " << name << ": median " << (long long) (result.median / 1e3) << " µs (95% CI "
+                      << (long long) (result.medianLow / 1e3) << " - " << (long long) (result.medianHigh / 1e3) << " µs)";
+
+            //Checking that the sorting method sorted the list correctly. The copy holds the list from the last sort.
+            if (checkSums(copy, SIZE) != sum || !checkOrder(copy, SIZE)) {
+                std::cout << " (NOT SORTED CORRECTLY)";
+            }
+
+            std::cout << "\n";
+            results.push_back(result);
+        }
     }
 
-    //Initialize two different lists of already sorted integers.
-    int* sortedList1 = new int[SIZE];
-    int* sortedList2 = new int[SIZE];
+    std::cout << std::endl;
 
-    for (int i = 0; i < SIZE; i++) {
-        sortedList1[i] = rand();
-        sortedList2[i] = rand(); 
+    //Writing the results as JSON if a filename is given: quicksort results.json
+    if (argc == 2 && !writeBenchmarkJson(results, argv[1])) {
+        std::cout << "Could not write the results to " << argv[1] << std::endl;
+        return 1;
     }
-    
-    std::sort(sortedList1, sortedList1 + SIZE);
-    std::sort(sortedList2, sortedList2 + SIZE);    
-
-    //Measure time for the single pivot quicksort for a list of random integers.
-    auto start = std::chrono::high_resolution_clock::now();
-    singlePivotQuicksort(list1, 0, SIZE - 1);
-    auto end = std::chrono::high_resolution_clock::now();
-    auto timeUsedSinglePivotRandom = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-    //Measure time for the dual pivot quicksort for a list of random integers..
-    start = std::chrono::high_resolution_clock::now();
-    dualPivotQuicksort(list2, 0, SIZE - 1);
-    end = std::chrono::high_resolution_clock::now();
-    auto timeUsedDualPivotRandom = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-    //Measure time for the single pivot quicksort for a list of random integers with several duplicates.
-    start = std::chrono::high_resolution_clock::now();
-    singlePivotQuicksort(listWithDuplicates1, 0, SIZE - 1);
-    end = std::chrono::high_resolution_clock::now();
-    auto timeUsedSinglePivotDuplicate = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-    //Measure time for the dual pivot quicksort for a list of random integers with several duplicates.
-    start = std::chrono::high_resolution_clock::now();
-    singlePivotQuicksort(listWithDuplicates2, 0, SIZE - 1);
-    end = std::chrono::high_resolution_clock::now();
-    auto timeUsedDualPivotDuplicate = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-    //Measure time for the single pivot quicksort for a list that is already sorted.
-    start = std::chrono::high_resolution_clock::now();
-    singlePivotQuicksort(sortedList1, 0, SIZE - 1);
-    end = std::chrono::high_resolution_clock::now();
-    auto timeUsedSinglePivotSorted = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-    //Measure time for the dual pivot quicksort for a list that is already sorted.
-    start = std::chrono::high_resolution_clock::now();
-    singlePivotQuicksort(sortedList2, 0, SIZE - 1);
-    end = std::chrono::high_resolution_clock::now();
-    auto timeUsedDualPivotSorted = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-    //Print results.
-    std::cout << "\n\nTime used for single pivot quicksort on list of random integers: " << timeUsedSinglePivotRandom.count() << " µs\n";
-    std::cout << "Time used for dual pivot quicksort on list of random integers: " << timeUsedDualPivotRandom.count() << " µs\n\n";
-    std::cout << "Time used for single pivot quicksort on list with duplicates: " << timeUsedSinglePivotDuplicate.count() << " µs\n";
-    std::cout << "Time used for dual pivot quicksort on list with duplicates: " << timeUsedDualPivotDuplicate.count() << " µs\n\n";
-    std::cout << "Time used for single pivot quicksort on a list that is already sorted: " << timeUsedSinglePivotSorted.count() << " µs\n";
-    std::cout << "Time used for dual pivot quicksort on a list that is already sorted: " << timeUsedDualPivotSorted.count() << " µs" << std::endl;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,507 @@
+#ifndef QUICKSORT_H
+#define QUICKSORT_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "workStealingPool.h"
+
+//The sorting methods from quicksort.cpp as templates over random-access iterators and a comparator less(a, b).
+//Every range is [first, last). Elements are only moved and swapped, never copied, so sorting std::string or
+//key/payload structs does not allocate.
+
+//Ranges with at most this many elements are finished with insertion sort.
+#define INSERTION_SORT_THRESHOLD 16
+
+//Ranges with at least this many elements are sampled to see if they have few distinct values.
+#define THREE_WAY_MIN_SIZE 1024
+//Number of elements in the sample, and how many of them must be repeats to use the three-way partition.
+#define DISTINCT_SAMPLE_SIZE 32
+#define DISTINCT_SAMPLE_REPEATS 8
+
+//Largest number of presorted runs that are merged instead of quicksorted, and the smallest part of the range they
+//must cover (1 / PRESORTED_MIN_COVER). The rest of the range after the runs is sorted on its own and merged as one more run.
+#define PRESORTED_MAX_RUNS 16
+#define PRESORTED_MIN_COVER 2
+
+//Ranges with fewer elements than this are sorted sequentially by the parallel sort instead of being split further.
+#define PARALLEL_CUTOFF 65536
+
+//Method to sort a small range by inserting each element into the sorted part before it.
+template <typename Iterator, typename Compare>
+void insertionSort(Iterator first, Iterator last, Compare less) {
+    if (first == last) {
+        return;
+    }
+
+    for (Iterator i = first + 1; i != last; ++i) {
+        auto value = std::move(*i);
+        Iterator j = i;
+
+        while (j != first && less(value, *(j - 1))) {
+            *j = std::move(*(j - 1));
+            --j;
+        }
+
+        *j = std::move(value);
+    }
+}
+
+//Method to move an element down in a max-heap stored in [first, first + size) until both children are smaller.
+template <typename Iterator, typename Compare>
+void siftDown(Iterator first, typename std::iterator_traits<Iterator>::difference_type root,
+              typename std::iterator_traits<Iterator>::difference_type size, Compare less) {
+    auto value = std::move(first[root]);
+
+    for (;;) {
+        auto child = 2 * root + 1;
+
+        if (child >= size) {
+            break;
+        }
+
+        if (child + 1 < size && less(first[child], first[child + 1])) {
+            child++;
+        }
+
+        if (!less(value, first[child])) {
+            break;
+        }
+
+        first[root] = std::move(first[child]);
+        root = child;
+    }
+
+    first[root] = std::move(value);
+}
+
+//Method to sort a range by building a max-heap and moving the largest element to the end of the range.
+template <typename Iterator, typename Compare>
+void heapsort(Iterator first, Iterator last, Compare less) {
+    auto size = last - first;
+
+    for (auto root = size / 2 - 1; root >= 0; root--) {
+        siftDown(first, root, size, less);
+    }
+
+    for (auto end = size - 1; end > 0; end--) {
+        std::iter_swap(first, first + end);
+        siftDown(first, 0, end, less);
+    }
+}
+
+//Method to sort the first, middle and last element to find the median, from "Algoritmer og Datastrukturer med
+//eksempler i C og Java" by Hafting & Ljosland (2014). Returns the middle element.
+template <typename Iterator, typename Compare>
+Iterator median3sort(Iterator first, Iterator last, Compare less) {
+    Iterator v = first;
+    Iterator h = last - 1;
+    Iterator m = first + (h - first) / 2;
+
+    if (less(*m, *v)) {
+        std::iter_swap(v, m);
+    }
+    if (less(*h, *m)) {
+        std::iter_swap(m, h);
+        if (less(*m, *v)) {
+            std::iter_swap(v, m);
+        }
+    }
+
+    return m;
+}
+
+//Method to find a divisor value and place the lower values before it, and higher values after it. Needs at least 3 elements.
+//From "Algoritmer og Datastrukturer med eksempler i C og Java" by Hafting & Ljosland (2014).
+//The pivot stays at h - 1 during the loop, so it is compared by reference instead of being copied.
+template <typename Iterator, typename Compare>
+Iterator singlePivotPartition(Iterator first, Iterator last, Compare less) {
+    Iterator h = last - 1;
+    Iterator m = median3sort(first, last, less);
+    std::iter_swap(m, h - 1);
+    const auto& dv = *(h - 1);
+    Iterator iv = first;
+    Iterator ih = h - 1;
+
+    for (;;) {
+        while (less(*++iv, dv));
+        while (less(dv, *--ih));
+
+        if (iv >= ih) {
+            break;
+        }
+
+        std::iter_swap(iv, ih);
+    }
+
+    std::iter_swap(iv, h - 1);
+    return iv;
+}
+
+//Method to check if a range has few distinct values, by sorting an evenly spaced sample and counting repeats.
+//The sample holds iterators, so no elements are copied.
+template <typename Iterator, typename Compare>
+bool hasFewDistinctValues(Iterator first, Iterator last, Compare less) {
+    Iterator sample[DISTINCT_SAMPLE_SIZE];
+    auto step = (last - first - 1) / (DISTINCT_SAMPLE_SIZE - 1);
+
+    for (int i = 0; i < DISTINCT_SAMPLE_SIZE; i++) {
+        sample[i] = first + i * step;
+    }
+
+    insertionSort(sample, sample + DISTINCT_SAMPLE_SIZE, [&less](Iterator a, Iterator b) { return less(*a, *b); });
+
+    int repeats = 0;
+
+    for (int i = 1; i < DISTINCT_SAMPLE_SIZE; i++) {
+        if (!less(*sample[i - 1], *sample[i])) {
+            repeats++;
+        }
+    }
+
+    return repeats >= DISTINCT_SAMPLE_REPEATS;
+}
+
+//Method to split a range into elements smaller than, equal to and larger than the pivot (Dijkstra's Dutch national flag).
+//Afterwards [first, lt) < pivot, [lt, gt) == pivot and [gt, last) > pivot.
+//The pivot is compared through *low, which always holds an element equal to the pivot.
+template <typename Iterator, typename Compare>
+void threeWayPartition(Iterator first, Iterator last, Compare less, Iterator* lt, Iterator* gt) {
+    std::iter_swap(first, median3sort(first, last, less));
+    Iterator low = first;
+    Iterator i = first + 1;
+    Iterator high = last;
+
+    while (i < high) {
+        if (less(*i, *low)) {
+            std::iter_swap(low, i);
+            ++low;
+            ++i;
+        } else if (less(*low, *i)) {
+            --high;
+            std::iter_swap(i, high);
+        } else {
+            ++i;
+        }
+    }
+
+    *lt = low;
+    *gt = high;
+}
+
+//Method to merge the sorted ranges [first, middle) and [middle, last) without a buffer, so it does not allocate.
+//The middle element of the longer range is found in the other range with a binary search, the two parts between them
+//are swapped with a rotation, and the two halves are merged the same way. The rotations on each level of this
+//recursion move every element at most once, so a merge costs O(n log n) moves instead of the O(n) of a buffered merge.
+template <typename Iterator, typename Compare>
+void mergeWithoutBuffer(Iterator first, Iterator middle, Iterator last, Compare less) {
+    while (first != middle && middle != last && less(*middle, *(middle - 1))) {
+        if (middle - first == 1 && last - middle == 1) {
+            std::iter_swap(first, middle);
+            return;
+        }
+
+        Iterator firstCut;
+        Iterator secondCut;
+
+        if (middle - first > last - middle) {
+            firstCut = first + (middle - first) / 2;
+            secondCut = std::lower_bound(middle, last, *firstCut, less);
+        } else {
+            secondCut = middle + (last - middle) / 2;
+            firstCut = std::upper_bound(first, middle, *secondCut, less);
+        }
+
+        Iterator newMiddle = std::rotate(firstCut, middle, secondCut);
+
+        //Recursing on the smaller half and looping on the larger one, so the stack stays O(log n).
+        if (newMiddle - first < last - newMiddle) {
+            mergeWithoutBuffer(first, firstCut, newMiddle, less);
+            first = newMiddle;
+            middle = secondCut;
+        } else {
+            mergeWithoutBuffer(newMiddle, secondCut, last, less);
+            last = newMiddle;
+            middle = firstCut;
+        }
+    }
+}
+
+//Method to find the runs at the start of a range that are already ascending or descending, like TimSort and pdqsort.
+//Descending runs are reversed, and may hold equal elements since the sort does not need to be stable. If there are at
+//most PRESORTED_MAX_RUNS runs, or the runs cover enough of the range and the rest is sorted with sortRest(first, last),
+//the runs are merged pairwise and true is returned. Otherwise the range is left for the quicksort, after at most
+//PRESORTED_MAX_RUNS runs have been read. A sorted or reverse sorted range is therefore sorted in O(n) time.
+//The merges use mergeWithoutBuffer, so this does not allocate either, and the sort stays within the memory budget
+//of externalSort.
+template <typename Iterator, typename Compare, typename SortRest>
+bool sortPresortedRuns(Iterator first, Iterator last, Compare less, SortRest sortRest) {
+    if (last - first <= INSERTION_SORT_THRESHOLD) {
+        return false;
+    }
+
+    Iterator bounds[PRESORTED_MAX_RUNS + 2];
+    int runs = 0;
+    Iterator end = first;
+    bounds[0] = first;
+
+    while (end != last && runs < PRESORTED_MAX_RUNS) {
+        Iterator start = end++;
+
+        //Skipping elements equal to the first, so a descending run that starts with equal elements is still found.
+        while (end != last && !less(*end, *start) && !less(*start, *end)) {
+            ++end;
+        }
+
+        if (end != last && less(*end, *start)) {
+            while (end != last && !less(*(end - 1), *end)) {
+                ++end;
+            }
+
+            std::reverse(start, end);
+        } else {
+            while (end != last && !less(*end, *(end - 1))) {
+                ++end;
+            }
+        }
+
+        bounds[++runs] = end;
+    }
+
+    if (end != last) {
+        if (end - first < (last - first) / PRESORTED_MIN_COVER) {
+            return false;
+        }
+
+        sortRest(end, last);
+        bounds[++runs] = last;
+    }
+
+    //Merging neighbouring runs until one run is left, so every element is moved about log2(runs) times.
+    while (runs > 1) {
+        int merged = 0;
+
+        for (int i = 0; i < runs; i += 2) {
+            if (i + 1 < runs) {
+                mergeWithoutBuffer(bounds[i], bounds[i + 1], bounds[i + 2], less);
+            }
+
+            bounds[++merged] = bounds[std::min(i + 2, runs)];
+        }
+
+        runs = merged;
+    }
+
+    return true;
+}
+
+//Method to partition the range until it is small, recursing on the smaller part and looping on the larger part.
+//If the partitions keep being uneven and the depth limit is reached, the rest of the range is heapsorted.
+template <typename Iterator, typename Compare, typename Partition>
+void introsortLoop(Iterator first, Iterator last, int depthLimit, Compare less, Partition partition) {
+    while (last - first > INSERTION_SORT_THRESHOLD) {
+        if (depthLimit == 0) {
+            heapsort(first, last, less);
+            return;
+        }
+
+        depthLimit--;
+
+        //With many equal elements, the elements equal to the pivot are grouped and left out of the recursion.
+        if (last - first >= THREE_WAY_MIN_SIZE && hasFewDistinctValues(first, last, less)) {
+            Iterator lt, gt;
+            threeWayPartition(first, last, less, &lt, &gt);
+
+            if (lt - first < last - gt) {
+                introsortLoop(first, lt, depthLimit, less, partition);
+                first = gt;
+            } else {
+                introsortLoop(gt, last, depthLimit, less, partition);
+                last = lt;
+            }
+
+            continue;
+        }
+
+        Iterator dividePos = partition(first, last, less);
+
+        if (dividePos - first < last - dividePos) {
+            introsortLoop(first, dividePos, depthLimit, less, partition);
+            first = dividePos + 1;
+        } else {
+            introsortLoop(dividePos + 1, last, depthLimit, less, partition);
+            last = dividePos;
+        }
+    }
+
+    insertionSort(first, last, less);
+}
+
+//Quicksort method based on the one from "Algoritmer og Datastrukturer med eksempler i C og Java" by Hafting & Ljosland (2014).
+//Changed to an introsort, so every input is sorted in O(n log n) time and the stack depth is O(log n).
+//partition(first, last, less) places a pivot and returns its position, like singlePivotPartition.
+template <typename Iterator, typename Compare, typename Partition>
+void singlePivotQuicksort(Iterator first, Iterator last, Compare less, Partition partition) {
+    auto sortRange = [less, partition](Iterator first, Iterator last) {
+        int depthLimit = 0;
+
+        //The depth limit is 2 * log2(n).
+        for (auto n = last - first; n > 1; n /= 2) {
+            depthLimit += 2;
+        }
+
+        introsortLoop(first, last, depthLimit, less, partition);
+    };
+
+    if (!sortPresortedRuns(first, last, less, sortRange)) {
+        sortRange(first, last);
+    }
+}
+
+template <typename Iterator, typename Compare>
+void singlePivotQuicksort(Iterator first, Iterator last, Compare less) {
+    singlePivotQuicksort(first, last, less, singlePivotPartition<Iterator, Compare>);
+}
+
+template <typename Iterator>
+void singlePivotQuicksort(Iterator first, Iterator last) {
+    singlePivotQuicksort(first, last, std::less<typename std::iterator_traits<Iterator>::value_type>());
+}
+
+//Method to split and place the elements in the list using three different intervals. Returns the right pivot, and the
+//left pivot is stored in lp. Needs at least 2 elements.
+//Code retrieved from https://www.geeksforgeeks.org/dual-pivot-quicksort/ on September 9th, 2022.
+//Small edits implemented to compensate for weaknesses in the code.
+template <typename Iterator, typename Compare>
+Iterator dualPivotPartition(Iterator first, Iterator last, Compare less, Iterator* lp) {
+    Iterator low = first;
+    Iterator high = last - 1;
+
+    std::iter_swap(low, low + (high - low) / 3);
+    std::iter_swap(high, high - (high - low) / 3);
+
+    if (less(*high, *low))
+        std::iter_swap(low, high);
+    //p is the left pivot, and q is the right pivot. They stay at low and high until the end.
+    Iterator j = low + 1;
+    Iterator g = high - 1;
+    Iterator k = low + 1;
+    const auto& p = *low;
+    const auto& q = *high;
+
+    while (k <= g) {
+
+        //If elements are less than the left pivot
+        if (less(*k, p)) {
+            std::iter_swap(k, j);
+            ++j;
+        }
+
+        //If elements are greater than or equal
+        //To the right pivot
+        else if (!less(*k, q)) {
+            while (less(q, *g) && k < g)
+                --g;
+            std::iter_swap(k, g);
+            --g;
+            if (less(*k, p)) {
+                std::iter_swap(k, j);
+                ++j;
+            }
+        }
+        ++k;
+    }
+    --j;
+    ++g;
+
+    //Bring pivots to their appropriate positions.
+    std::iter_swap(low, j);
+    std::iter_swap(high, g);
+
+    *lp = j;
+    return g;
+}
+
+//Method to perform a dual pivot quicksort on a range, without looking for presorted runs.
+//Code retrieved from https://www.geeksforgeeks.org/dual-pivot-quicksort/ on September 9th, 2022.
+template <typename Iterator, typename Compare>
+void dualPivotSortRange(Iterator first, Iterator last, Compare less) {
+    //With many equal elements, the elements equal to the pivot are grouped and left out of the recursion.
+    if (last - first >= THREE_WAY_MIN_SIZE && hasFewDistinctValues(first, last, less)) {
+        Iterator lt, gt;
+        threeWayPartition(first, last, less, &lt, &gt);
+        dualPivotSortRange(first, lt, less);
+        dualPivotSortRange(gt, last, less);
+        return;
+    }
+
+    if (last - first > 1) {
+        //lp means left pivot, and rp means right pivot.
+        Iterator lp, rp;
+        rp = dualPivotPartition(first, last, less, &lp);
+        dualPivotSortRange(first, lp, less);
+        dualPivotSortRange(lp + 1, rp, less);
+        dualPivotSortRange(rp + 1, last, less);
+    }
+}
+
+//Method to perform a dual pivot quicksort, after checking for presorted runs.
+template <typename Iterator, typename Compare>
+void dualPivotQuicksort(Iterator first, Iterator last, Compare less) {
+    auto sortRange = [less](Iterator first, Iterator last) { dualPivotSortRange(first, last, less); };
+
+    if (!sortPresortedRuns(first, last, less, sortRange)) {
+        sortRange(first, last);
+    }
+}
+
+template <typename Iterator>
+void dualPivotQuicksort(Iterator first, Iterator last) {
+    dualPivotQuicksort(first, last, std::less<typename std::iterator_traits<Iterator>::value_type>());
+}
+
+//Method to sort a range as a task in the pool. Two of the three ranges from each dual pivot partition are spawned
+//as new tasks, and the task continues with the third range itself, until the range is below the cutoff.
+template <typename Iterator, typename Compare>
+void parallelDualPivotTask(WorkStealingPool* pool, Iterator first, Iterator last, Compare less) {
+    while (last - first >= PARALLEL_CUTOFF) {
+        if (hasFewDistinctValues(first, last, less)) {
+            Iterator lt, gt;
+            threeWayPartition(first, last, less, &lt, &gt);
+            pool->spawn([pool, first, lt, less]() { parallelDualPivotTask(pool, first, lt, less); });
+            first = gt;
+            continue;
+        }
+
+        Iterator lp, rp;
+        rp = dualPivotPartition(first, last, less, &lp);
+        pool->spawn([pool, first, lp, less]() { parallelDualPivotTask(pool, first, lp, less); });
+        pool->spawn([pool, lp, rp, less]() { parallelDualPivotTask(pool, lp + 1, rp, less); });
+        first = rp + 1;
+    }
+
+    dualPivotSortRange(first, last, less);
+}
+
+//Method to perform a dual pivot quicksort on several threads, using a work-stealing thread pool.
+template <typename Iterator, typename Compare>
+void parallelDualPivotQuicksort(Iterator first, Iterator last, Compare less, int threadCount) {
+    auto sortRange = [less, threadCount](Iterator first, Iterator last) {
+        if (threadCount <= 1 || last - first < PARALLEL_CUTOFF) {
+            dualPivotSortRange(first, last, less);
+            return;
+        }
+
+        WorkStealingPool pool(threadCount);
+        pool.spawn([&pool, first, last, less]() { parallelDualPivotTask(&pool, first, last, less); });
+        pool.wait();
+    };
+
+    if (!sortPresortedRuns(first, last, less, sortRange)) {
+        sortRange(first, last);
+    }
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <string.h>
+#include <thread>
+#include <vector>
+
+//LSD radix sort for 32-bit integers, sorting on one 8-bit digit per pass from the least significant digit.
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (32 / RADIX_BITS)
+//Number of elements buffered per bucket before they are written out together (one 64 byte cache line).
+#define RADIX_BUFFER 16
+
+//Method to turn an int into an unsigned key with the same order, by flipping the sign bit.
+inline unsigned int radixKey(int value) {
+    return (unsigned int) value ^ 0x80000000u;
+}
+
+//Method to count the digits of t[first..last) for every pass.
+inline void radixHistogram(const int* t, long long first, long long last, unsigned long long counts[RADIX_PASSES][RADIX_BUCKETS]) {
+    memset(counts, 0, sizeof(unsigned long long) * RADIX_PASSES * RADIX_BUCKETS);
+
+    for (long long i = first; i < last; i++) {
+        unsigned int key = radixKey(t[i]);
+
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+}
+
+//Method to move the elements of from into to, ordered by the digit of the pass.
+//Elements are collected in a small buffer per bucket and written a cache line at a time (software write-combining),
+//so the writes to 256 different places in to do not evict each other from the cache.
+inline void radixScatter(const int* from, int* to, long long n, int pass, const unsigned long long* counts) {
+    alignas(64) int buffer[RADIX_BUCKETS][RADIX_BUFFER];
+    int fill[RADIX_BUCKETS] = {};
+    unsigned long long offset[RADIX_BUCKETS];
+    unsigned long long position = 0;
+    int shift = pass * RADIX_BITS;
+
+    for (int bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+        offset[bucket] = position;
+        position += counts[bucket];
+    }
+
+    for (long long i = 0; i < n; i++) {
+        int bucket = (radixKey(from[i]) >> shift) & (RADIX_BUCKETS - 1);
+        buffer[bucket][fill[bucket]++] = from[i];
+
+        if (fill[bucket] == RADIX_BUFFER) {
+            memcpy(to + offset[bucket], buffer[bucket], sizeof(buffer[bucket]));
+            offset[bucket] += RADIX_BUFFER;
+            fill[bucket] = 0;
+        }
+    }
+
+    for (int bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+        memcpy(to + offset[bucket], buffer[bucket], fill[bucket] * sizeof(int));
+    }
+}
+
+//Method to sort t[v..h] with an LSD radix sort. The histograms are counted on threadCount threads.
+//Passes where every element has the same digit are skipped, since they would not change the order.
+inline void radixSort(int* t, int v, int h, int threadCount = 1) {
+    long long n = (long long) h - v + 1;
+
+    if (n < 2) {
+        return;
+    }
+
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+
+    //Counting the digits for all passes in one read of the list, one part of the list per thread.
+    std::vector<unsigned long long> threadCounts((size_t) threadCount * RADIX_PASSES * RADIX_BUCKETS);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadCount; i++) {
+        long long first = v + n * i / threadCount;
+        long long last = v + n * (i + 1) / threadCount;
+        unsigned long long (*counts)[RADIX_BUCKETS] = (unsigned long long (*)[RADIX_BUCKETS]) (threadCounts.data() + (size_t) i * RADIX_PASSES * RADIX_BUCKETS);
+
+        if (i == threadCount - 1) {
+            radixHistogram(t, first, last, counts);
+        } else {
+            threads.emplace_back(radixHistogram, t, first, last, counts);
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    unsigned long long counts[RADIX_PASSES][RADIX_BUCKETS] = {};
+
+    for (int i = 0; i < threadCount; i++) {
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            for (int bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+                counts[pass][bucket] += threadCounts[((size_t) i * RADIX_PASSES + pass) * RADIX_BUCKETS + bucket];
+            }
+        }
+    }
+
+    std::vector<int> temp(n);
+    int* from = t + v;
+    int* to = temp.data();
+
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        bool constantDigit = false;
+
+        for (int bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+            if (counts[pass][bucket] == (unsigned long long) n) {
+                constantDigit = true;
+            }
+        }
+
+        if (constantDigit) {
+            continue;
+        }
+
+        radixScatter(from, to, n, pass, counts[pass]);
+
+        int* swapped = from;
+        from = to;
+        to = swapped;
+    }
+
+    //After an odd number of passes the sorted elements are in the temporary list.
+    if (from != t + v) {
+        memcpy(t + v, from, n * sizeof(int));
+    }
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Thread pool where every worker has its own queue of tasks.
+//A worker adds new tasks to the back of its own queue and takes them from the back (the newest, smallest tasks),
+//and when its queue is empty it steals from the front of another worker's queue (the oldest, largest tasks).
+class WorkStealingPool {
+    typedef std::function<void()> Task;
+
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<Worker*> workers;
+    std::vector<std::thread> threads;
+    //Number of tasks that are queued or running.
+    std::atomic<long long> pending;
+    //Number of tasks in the queues. It is changed under the lock of the queue, so it is 0 only when all queues are empty.
+    std::atomic<long long> queued;
+    std::atomic<bool> stopping;
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+    std::condition_variable done;
+
+    //Method to get the index of the worker running on this thread, or -1 if this is not a worker thread of this pool.
+    int currentWorker() {
+        return currentPool() == this ? currentIndex() : -1;
+    }
+
+    static WorkStealingPool*& currentPool() {
+        thread_local WorkStealingPool* pool = NULL;
+        return pool;
+    }
+
+    static int& currentIndex() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    //Method to take a task, first from the worker's own queue and then from the other workers.
+    bool takeTask(int index, Task& task) {
+        {
+            std::lock_guard<std::mutex> guard(this->workers[index]->lock);
+
+            if (!this->workers[index]->tasks.empty()) {
+                task = std::move(this->workers[index]->tasks.back());
+                this->workers[index]->tasks.pop_back();
+                this->queued--;
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < this->workers.size(); i++) {
+            Worker* victim = this->workers[(index + i) % this->workers.size()];
+            std::lock_guard<std::mutex> guard(victim->lock);
+
+            if (!victim->tasks.empty()) {
+                task = std::move(victim->tasks.front());
+                victim->tasks.pop_front();
+                this->queued--;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void run(int index) {
+        currentPool() = this;
+        currentIndex() = index;
+        Task task;
+
+        while (!this->stopping) {
+            if (takeTask(index, task)) {
+                task();
+                task = nullptr;
+
+                if (--this->pending == 0) {
+                    std::lock_guard<std::mutex> guard(this->sleepLock);
+                    this->done.notify_all();
+                }
+
+                continue;
+            }
+
+            //Sleeping until a task is added. A task added after takeTask looked at the queues has already counted itself in
+            //queued, or is counted before spawn takes sleepLock to notify, which is after this worker is waiting.
+            std::unique_lock<std::mutex> guard(this->sleepLock);
+            this->wakeUp.wait(guard, [this]() { return this->queued > 0 || this->stopping; });
+        }
+    }
+
+    public:
+    WorkStealingPool(int threadCount) : pending(0), queued(0), stopping(false) {
+        if (threadCount < 1) {
+            threadCount = 1;
+        }
+
+        for (int i = 0; i < threadCount; i++) {
+            this->workers.push_back(new Worker());
+        }
+
+        for (int i = 0; i < threadCount; i++) {
+            this->threads.emplace_back(&WorkStealingPool::run, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        wait();
+
+        {
+            std::lock_guard<std::mutex> guard(this->sleepLock);
+            this->stopping = true;
+            this->wakeUp.notify_all();
+        }
+
+        for (auto& thread : this->threads) {
+            thread.join();
+        }
+
+        for (Worker* worker : this->workers) {
+            delete worker;
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    //Method to add a task. Tasks added from a worker go to that worker's queue, other tasks go to the first worker.
+    void spawn(Task task) {
+        int index = currentWorker();
+        Worker* worker = this->workers[index >= 0 ? index : 0];
+
+        this->pending++;
+
+        {
+            std::lock_guard<std::mutex> guard(worker->lock);
+            worker->tasks.push_back(std::move(task));
+            this->queued++;
+        }
+
+        std::lock_guard<std::mutex> guard(this->sleepLock);
+        this->wakeUp.notify_one();
+    }
+
+    //Method to wait until all tasks, including the tasks they spawn, are done. Must not be called from a worker.
+    void wait() {
+        std::unique_lock<std::mutex> guard(this->sleepLock);
+        this->done.wait(guard, [this]() { return this->pending == 0; });
+    }
+
+    //Method to get the number of worker threads.
+    int size() const {
+        return (int) this->threads.size();
+    }
+};
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//Number of decimal digits in a limb, and the value one past the largest limb.
+//With base 10^18 a limb holds 18 digits, and reading and printing decimal numbers takes linear time.
+#define LIMB_DIGITS 18
+#define LIMB_BASE 1000000000000000000ULL
+
+//Structure for BigInt: an integer stored as its sign and its limbs in base 10^18, least significant limb first.
+//There are no leading zero limbs, so 0 has length 0.
+typedef struct {
+    uint64_t* limbs;
+    size_t length;
+    size_t capacity;
+    int negative;
+} BigInt;
+
+//Method to create a big integer with room for capacity limbs, with the value 0.
+static BigInt* newBigInt(size_t capacity) {
+    BigInt* number = (BigInt*)malloc(sizeof(BigInt));
+
+    number->limbs = (uint64_t*)malloc((capacity ? capacity : 1) * sizeof(uint64_t));
+    number->length = 0;
+    number->capacity = capacity ? capacity : 1;
+    number->negative = 0;
+
+    return number;
+}
+
+//Method to free a big integer.
+static void freeBigInt(BigInt* number) {
+    if (number) {
+        free(number->limbs);
+        free(number);
+    }
+}
+
+//Method to remove leading zero limbs. 0 is never negative.
+static void trimBigInt(BigInt* number) {
+    while (number->length > 0 && number->limbs[number->length - 1] == 0) {
+        number->length--;
+    }
+
+    if (number->length == 0) {
+        number->negative = 0;
+    }
+}
+
+//Method to read the value of up to 18 decimal digits.
+static uint64_t parseLimb(const char* digits, size_t count) {
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        value = value * 10 + (uint64_t)(digits[i] - '0');
+    }
+
+    return value;
+}
+
+//Method to create a big integer from a decimal string with an optional '-' in front.
+//Returns NULL if the string is not a valid number.
+static BigInt* bigIntFromString(const char* string) {
+    int negative = *string == '-';
+    const char* digits = string + negative;
+    size_t count = strlen(digits);
+
+    if (count == 0) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (digits[i] < '0' || digits[i] > '9') {
+            return NULL;
+        }
+    }
+
+    BigInt* number = newBigInt((count + LIMB_DIGITS - 1) / LIMB_DIGITS);
+
+    //Reading 18 digits at a time from the end, so the first limb gets the digits that are left over.
+    size_t end = count;
+
+    while (end > 0) {
+        size_t start = end > LIMB_DIGITS ? end - LIMB_DIGITS : 0;
+        number->limbs[number->length++] = parseLimb(digits + start, end - start);
+        end = start;
+    }
+
+    number->negative = negative;
+    trimBigInt(number);
+
+    return number;
+}
+
+//Method to find the number of decimal digits in a big integer, without the sign.
+static size_t bigIntDigits(const BigInt* number) {
+    if (number->length == 0) {
+        return 1;
+    }
+
+    size_t digits = (number->length - 1) * LIMB_DIGITS;
+
+    for (uint64_t top = number->limbs[number->length - 1]; top > 0; top /= 10) {
+        digits++;
+    }
+
+    return digits;
+}
+
+//Method to write the 18 digits of a limb, with leading zeros. The limb is split in two halves of 9 digits,
+//so the divisions are on 32-bit numbers.
+static void writeLimb(char* out, uint64_t limb) {
+    uint32_t high = (uint32_t)(limb / 1000000000ULL);
+    uint32_t low = (uint32_t)(limb % 1000000000ULL);
+
+    for (int i = 8; i >= 0; i--) {
+        out[i] = (char)('0' + high % 10);
+        out[9 + i] = (char)('0' + low % 10);
+        high /= 10;
+        low /= 10;
+    }
+}
+
+//Method to convert a big integer to a decimal string. The string must be freed by the caller.
+static char* bigIntToString(const BigInt* number) {
+    size_t digits = bigIntDigits(number);
+    char* res = (char*)malloc(digits + number->negative + 1);
+    char* out = res;
+
+    if (number->negative) {
+        *out++ = '-';
+    }
+
+    if (number->length == 0) {
+        *out++ = '0';
+    } else {
+        //The most significant limb is written without leading zeros, and every other limb with all 18 digits.
+        char first[LIMB_DIGITS];
+        size_t firstDigits = digits - (number->length - 1) * LIMB_DIGITS;
+        writeLimb(first, number->limbs[number->length - 1]);
+        memcpy(out, first + LIMB_DIGITS - firstDigits, firstDigits);
+        out += firstDigits;
+
+        for (size_t i = number->length - 1; i-- > 0;) {
+            writeLimb(out, number->limbs[i]);
+            out += LIMB_DIGITS;
+        }
+    }
+
+    *out = 0;
+    return res;
+}
+
+//Method to print a big integer, right aligned in width characters.
+static void printBigInt(const BigInt* number, int width) {
+    char* string = bigIntToString(number);
+    printf("%*s", width, string);
+    free(string);
+}
+
+//Method to compare the absolute values of two big integers. Returns -1, 0 or 1.
+static int compareMagnitude(const BigInt* lhs, const BigInt* rhs) {
+    if (lhs->length != rhs->length) {
+        return lhs->length < rhs->length ? -1 : 1;
+    }
+
+    for (size_t i = lhs->length; i-- > 0;) {
+        if (lhs->limbs[i] != rhs->limbs[i]) {
+            return lhs->limbs[i] < rhs->limbs[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+//Method to add the na limbs of a and the nb limbs of b into res, when na >= nb. res may be a.
+//Returns the carry out of the last limb.
+//The carry is a 0 or 1 that is found with a comparison instead of a branch, so the loop has no data-dependent branches.
+static uint64_t addLimbs(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    uint64_t carry = 0;
+    size_t i = 0;
+
+    for (; i < nb; i++) {
+        uint64_t sum = a[i] + b[i] + carry;
+        carry = sum >= LIMB_BASE;
+        res[i] = sum - (carry ? LIMB_BASE : 0);
+    }
+
+    for (; i < na; i++) {
+        uint64_t sum = a[i] + carry;
+        carry = sum >= LIMB_BASE;
+        res[i] = sum - (carry ? LIMB_BASE : 0);
+    }
+
+    return carry;
+}
+
+//Method to subtract the nb limbs of b from the na limbs of a into res, when na >= nb. res may be a.
+//Returns the borrow out of the last limb, which is 0 when a >= b.
+//A negative difference gets LIMB_BASE added and borrows 1 from the next limb.
+static uint64_t subtractLimbs(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    uint64_t borrow = 0;
+    size_t i = 0;
+
+    for (; i < nb; i++) {
+        uint64_t difference = a[i] - b[i] - borrow;
+        borrow = a[i] < b[i] + borrow;
+        res[i] = difference + (borrow ? LIMB_BASE : 0);
+    }
+
+    for (; i < na; i++) {
+        uint64_t difference = a[i] - borrow;
+        borrow = a[i] < borrow;
+        res[i] = difference + (borrow ? LIMB_BASE : 0);
+    }
+
+    return borrow;
+}
+
+//Method to multiply the na limbs of a by a number below LIMB_BASE into res. res may be a.
+//Returns the limb carried out of the top.
+static uint64_t multiplySmall(uint64_t* res, const uint64_t* a, size_t na, uint64_t factor) {
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < na; i++) {
+        unsigned __int128 product = (unsigned __int128)a[i] * factor + carry;
+        carry = (uint64_t)(product / LIMB_BASE);
+        res[i] = (uint64_t)(product % LIMB_BASE);
+    }
+
+    return carry;
+}
+
+//Method to divide the na limbs of a by a number below LIMB_BASE into res, starting from the top. res may be a.
+//Returns the remainder.
+static uint64_t divideSmall(uint64_t* res, const uint64_t* a, size_t na, uint64_t divisor) {
+    uint64_t remainder = 0;
+
+    for (size_t i = na; i-- > 0;) {
+        unsigned __int128 value = (unsigned __int128)remainder * LIMB_BASE + a[i];
+        res[i] = (uint64_t)(value / divisor);
+        remainder = (uint64_t)(value % divisor);
+    }
+
+    return remainder;
+}
+
+//Method to add the absolute values of two big integers into res, which has room for the longest plus one limb.
+static void addMagnitude(BigInt* res, const BigInt* lhs, const BigInt* rhs) {
+    const BigInt* longer = lhs->length >= rhs->length ? lhs : rhs;
+    const BigInt* shorter = lhs->length >= rhs->length ? rhs : lhs;
+
+    res->limbs[longer->length] = addLimbs(res->limbs, longer->limbs, longer->length, shorter->limbs, shorter->length);
+    res->length = longer->length + 1;
+    trimBigInt(res);
+}
+
+//Method to subtract the absolute value of rhs from the absolute value of lhs into res, when |lhs| >= |rhs|.
+//res needs room for the length of lhs.
+static void subtractMagnitude(BigInt* res, const BigInt* lhs, const BigInt* rhs) {
+    subtractLimbs(res->limbs, lhs->limbs, lhs->length, rhs->limbs, rhs->length);
+    res->length = lhs->length;
+    trimBigInt(res);
+}
+
+//Method to add or subtract two big integers, where rhsNegative is the sign rhs is used with.
+static BigInt* addSigned(const BigInt* lhs, const BigInt* rhs, int rhsNegative) {
+    size_t longest = lhs->length > rhs->length ? lhs->length : rhs->length;
+    BigInt* res = newBigInt(longest + 1);
+
+    if (lhs->negative == rhsNegative) {
+        addMagnitude(res, lhs, rhs);
+        res->negative = lhs->negative;
+    } else if (compareMagnitude(lhs, rhs) >= 0) {
+        subtractMagnitude(res, lhs, rhs);
+        res->negative = lhs->negative;
+    } else {
+        subtractMagnitude(res, rhs, lhs);
+        res->negative = rhsNegative;
+    }
+
+    trimBigInt(res);
+    return res;
+}
+
+//Method to add two big integers.
+static BigInt* bigIntAdd(const BigInt* lhs, const BigInt* rhs) {
+    return addSigned(lhs, rhs, rhs->negative);
+}
+
+//Method to subtract rhs from lhs. Unlike subtract for Number, lhs may be smaller than rhs.
+static BigInt* bigIntSubtract(const BigInt* lhs, const BigInt* rhs) {
+    return addSigned(lhs, rhs, !rhs->negative);
+}
+
+#endif
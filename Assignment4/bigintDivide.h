@@ -0,0 +1,235 @@
+#ifndef BIGINT_DIVIDE_H
+#define BIGINT_DIVIDE_H
+
+#include "bigint.h"
+#include "bigintMultiply.h"
+
+//Number of limbs in both the divisor and the quotient from which Newton division is used, and the precision below
+//which the reciprocal is found with schoolbook division. The crossover was found with linkedlists -t.
+#define NEWTON_THRESHOLD 160
+
+//Method to divide u by v with Knuth's algorithm D, when nu >= nv >= 2 and the top limb of v is not 0.
+//The quotient gets nu - nv + 1 limbs and the remainder nv limbs, and either can be NULL if it is not needed.
+//Both numbers are first multiplied by d, so the top limb of v is at least LIMB_BASE / 2. Then the estimate of each
+//quotient limb from the top two limbs is at most 2 too large, and is corrected with the next limb and an add-back.
+static void divideSchoolbook(uint64_t* quotient, uint64_t* remainder, const uint64_t* u, size_t nu, const uint64_t* v,
+                             size_t nv) {
+    uint64_t d = LIMB_BASE / (v[nv - 1] + 1);
+    uint64_t* vn = (uint64_t*)malloc((nv + nu + 1) * sizeof(uint64_t));
+    uint64_t* un = vn + nv;
+
+    multiplySmall(vn, v, nv, d);
+    un[nu] = multiplySmall(un, u, nu, d);
+
+    for (size_t j = nu - nv + 1; j-- > 0;) {
+        unsigned __int128 top = (unsigned __int128)un[j + nv] * LIMB_BASE + un[j + nv - 1];
+        unsigned __int128 estimate = top / vn[nv - 1];
+        unsigned __int128 rest = top % vn[nv - 1];
+
+        while (estimate >= LIMB_BASE ||
+               estimate * vn[nv - 2] > rest * LIMB_BASE + un[j + nv - 2]) {
+            estimate--;
+            rest += vn[nv - 1];
+
+            if (rest >= LIMB_BASE) {
+                break;
+            }
+        }
+
+        //Subtracting estimate * v from the nv + 1 limbs of u starting at limb j.
+        uint64_t carry = 0;
+        uint64_t borrow = 0;
+
+        for (size_t i = 0; i < nv; i++) {
+            unsigned __int128 product = estimate * vn[i] + carry;
+            uint64_t subtrahend = (uint64_t)(product % LIMB_BASE) + borrow;
+            carry = (uint64_t)(product / LIMB_BASE);
+            borrow = un[i + j] < subtrahend;
+            un[i + j] = un[i + j] - subtrahend + (borrow ? LIMB_BASE : 0);
+        }
+
+        //The top limb wraps around if the estimate was 1 too large, and wraps back when v is added back.
+        uint64_t subtrahend = carry + borrow;
+        borrow = un[j + nv] < subtrahend;
+        un[j + nv] -= subtrahend;
+
+        if (borrow) {
+            estimate--;
+            un[j + nv] += addLimbs(un + j, un + j, nv, vn, nv);
+        }
+
+        if (quotient) {
+            quotient[j] = (uint64_t)estimate;
+        }
+    }
+
+    if (remainder) {
+        divideSmall(remainder, un, nv, d);
+    }
+
+    free(vn);
+}
+
+//Method to shift a big integer up by count limbs, which multiplies it by LIMB_BASE^count.
+static BigInt* shiftUp(const BigInt* number, size_t count) {
+    BigInt* res = newBigInt(number->length + count);
+
+    if (number->length > 0) {
+        memset(res->limbs, 0, count * sizeof(uint64_t));
+        memcpy(res->limbs + count, number->limbs, number->length * sizeof(uint64_t));
+        res->length = number->length + count;
+        res->negative = number->negative;
+    }
+
+    return res;
+}
+
+//Method to shift a big integer down by count limbs, which divides it by LIMB_BASE^count rounding towards zero.
+static BigInt* shiftDown(const BigInt* number, size_t count) {
+    size_t length = number->length > count ? number->length - count : 0;
+    BigInt* res = newBigInt(length);
+
+    memcpy(res->limbs, number->limbs + count, length * sizeof(uint64_t));
+    res->length = length;
+    res->negative = number->negative;
+    trimBigInt(res);
+
+    return res;
+}
+
+//Method to find about B^(m + k) / v with Newton's iteration, where v has m limbs and B is LIMB_BASE. The relative error
+//is about B^-k, so only the top k + 2 limbs of v are used. The reciprocal y at half the precision h gives the next one as
+//y * B^(k - h) + y * (B^(m + h) - v * y) / B^(m + 2h - k), which squares the relative error, so every step costs
+//a few multiplications of the current precision, and the whole reciprocal costs about as much as one multiplication.
+static BigInt* reciprocal(const uint64_t* v, size_t m, size_t k) {
+    if (m > k + 2) {
+        v += m - (k + 2);
+        m = k + 2;
+    }
+
+    if (k <= NEWTON_THRESHOLD) {
+        size_t nu = m + k + 1;
+        uint64_t* power = (uint64_t*)calloc(nu, sizeof(uint64_t));
+        BigInt* res = newBigInt(k + 2);
+
+        power[nu - 1] = 1;
+
+        if (m == 1) {
+            divideSmall(res->limbs, power, nu, v[0]);
+        } else {
+            divideSchoolbook(res->limbs, NULL, power, nu, v, m);
+        }
+
+        res->length = k + 2;
+        trimBigInt(res);
+        free(power);
+
+        return res;
+    }
+
+    size_t h = k / 2 + 1;
+    BigInt divisor = {(uint64_t*)v, m, m, 0};
+    BigInt* y = reciprocal(v, m, h);
+    BigInt* product = bigIntMultiply(&divisor, y);
+
+    //error = B^(m + h) - v * y, which is small and can be negative.
+    BigInt* power = newBigInt(m + h + 1);
+    memset(power->limbs, 0, (m + h) * sizeof(uint64_t));
+    power->limbs[m + h] = 1;
+    power->length = m + h + 1;
+
+    BigInt* error = bigIntSubtract(power, product);
+    BigInt* correction = bigIntMultiply(y, error);
+    BigInt* shiftedCorrection = shiftDown(correction, m + 2 * h - k);
+    BigInt* shifted = shiftUp(y, k - h);
+    BigInt* res = bigIntAdd(shifted, shiftedCorrection);
+
+    freeBigInt(y);
+    freeBigInt(product);
+    freeBigInt(power);
+    freeBigInt(error);
+    freeBigInt(correction);
+    freeBigInt(shiftedCorrection);
+    freeBigInt(shifted);
+
+    return res;
+}
+
+//Method to divide the absolute values of u by v with a reciprocal from Newton's iteration. The quotient from the
+//reciprocal is at most a few units off, so it is corrected until the remainder is between 0 and v.
+static void divideNewton(BigInt* quotient, BigInt* remainder, const BigInt* u, const BigInt* v) {
+    size_t k = u->length - v->length + 2;
+    BigInt absoluteU = {u->limbs, u->length, u->length, 0};
+    BigInt absoluteV = {v->limbs, v->length, v->length, 0};
+    BigInt* x = reciprocal(v->limbs, v->length, k);
+    BigInt* product = bigIntMultiply(&absoluteU, x);
+    BigInt* q = shiftDown(product, v->length + k);
+    BigInt* qv = bigIntMultiply(q, &absoluteV);
+    BigInt* r = bigIntSubtract(&absoluteU, qv);
+    uint64_t oneLimb = 1;
+    BigInt one = {&oneLimb, 1, 1, 0};
+
+    while (r->negative) {
+        replaceBigInt(&q, bigIntSubtract(q, &one));
+        replaceBigInt(&r, bigIntAdd(r, &absoluteV));
+    }
+
+    while (compareMagnitude(r, &absoluteV) >= 0) {
+        replaceBigInt(&q, bigIntAdd(q, &one));
+        replaceBigInt(&r, bigIntSubtract(r, &absoluteV));
+    }
+
+    memcpy(quotient->limbs, q->limbs, q->length * sizeof(uint64_t));
+    quotient->length = q->length;
+    memcpy(remainder->limbs, r->limbs, r->length * sizeof(uint64_t));
+    remainder->length = r->length;
+
+    freeBigInt(x);
+    freeBigInt(product);
+    freeBigInt(q);
+    freeBigInt(qv);
+    freeBigInt(r);
+}
+
+//Method to divide lhs by rhs, rounding towards zero like / in C. The remainder has the sign of lhs like % in C, and is
+//stored in *remainder if remainder is not NULL. Returns NULL if rhs is 0.
+static BigInt* bigIntDivide(const BigInt* lhs, const BigInt* rhs, BigInt** remainder) {
+    if (rhs->length == 0) {
+        return NULL;
+    }
+
+    size_t nu = lhs->length;
+    size_t nv = rhs->length;
+    BigInt* quotient = newBigInt(nu >= nv ? nu - nv + 1 : 1);
+    BigInt* rest = newBigInt(nv);
+
+    if (compareMagnitude(lhs, rhs) < 0) {
+        memcpy(rest->limbs, lhs->limbs, nu * sizeof(uint64_t));
+        rest->length = nu;
+    } else if (nv == 1) {
+        rest->limbs[0] = divideSmall(quotient->limbs, lhs->limbs, nu, rhs->limbs[0]);
+        quotient->length = nu;
+        rest->length = 1;
+    } else if (nv < NEWTON_THRESHOLD || nu - nv < NEWTON_THRESHOLD) {
+        divideSchoolbook(quotient->limbs, rest->limbs, lhs->limbs, nu, rhs->limbs, nv);
+        quotient->length = nu - nv + 1;
+        rest->length = nv;
+    } else {
+        divideNewton(quotient, rest, lhs, rhs);
+    }
+
+    quotient->negative = lhs->negative != rhs->negative;
+    rest->negative = lhs->negative;
+    trimBigInt(quotient);
+    trimBigInt(rest);
+
+    if (remainder) {
+        *remainder = rest;
+    } else {
+        freeBigInt(rest);
+    }
+
+    return quotient;
+}
+
+#endif
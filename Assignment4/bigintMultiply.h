@@ -0,0 +1,495 @@
+#ifndef BIGINT_MULTIPLY_H
+#define BIGINT_MULTIPLY_H
+
+#include "bigint.h"
+
+//Number of limbs in the shorter operand from which each method is used. The crossovers were found with linkedlists -t.
+#define KARATSUBA_THRESHOLD 48
+#define TOOM3_THRESHOLD 640
+#define NTT_THRESHOLD 8192
+
+//The schoolbook method adds up to this many products of two limbs in a 128-bit column sum, which is below the
+//2^128 / 10^36 = 340 products that fit.
+#define SCHOOLBOOK_BLOCK 256
+
+//Longest transform for NTT. 2^24 is the largest power of two that divides p - 1 for all three primes, so numbers
+//up to about 75 million digits can be multiplied with NTT.
+#define NTT_MAX_LENGTH (1 << 24)
+
+static void multiplyLimbs(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb);
+static BigInt* bigIntMultiply(const BigInt* lhs, const BigInt* rhs);
+
+//Method to multiply a by b column by column into res, which gets na + nb limbs. nb must be at most SCHOOLBOOK_BLOCK.
+//Every limb of the product is found from one column sum, so there is one division by LIMB_BASE per limb.
+static void multiplyColumns(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    unsigned __int128 column = 0;
+
+    for (size_t k = 0; k + 1 < na + nb; k++) {
+        size_t low = k >= nb ? k - nb + 1 : 0;
+        size_t high = k < na ? k : na - 1;
+
+        for (size_t i = low; i <= high; i++) {
+            column += (unsigned __int128)a[i] * b[k - i];
+        }
+
+        res[k] = (uint64_t)(column % LIMB_BASE);
+        column /= LIMB_BASE;
+    }
+
+    res[na + nb - 1] = (uint64_t)column;
+}
+
+//Method to multiply a by b with the schoolbook method into res, which gets na + nb limbs.
+//b is split in blocks of SCHOOLBOOK_BLOCK limbs, so the column sums do not overflow.
+static void multiplySchoolbook(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    if (nb <= SCHOOLBOOK_BLOCK) {
+        multiplyColumns(res, a, na, b, nb);
+        return;
+    }
+
+    uint64_t* block = (uint64_t*)malloc((na + SCHOOLBOOK_BLOCK) * sizeof(uint64_t));
+    memset(res, 0, (na + nb) * sizeof(uint64_t));
+
+    for (size_t offset = 0; offset < nb; offset += SCHOOLBOOK_BLOCK) {
+        size_t length = nb - offset < SCHOOLBOOK_BLOCK ? nb - offset : SCHOOLBOOK_BLOCK;
+        multiplyColumns(block, a, na, b + offset, length);
+        addLimbs(res + offset, res + offset, na + nb - offset, block, na + length);
+    }
+
+    free(block);
+}
+
+//Method to multiply a by b with Karatsuba's method into res, which gets na + nb limbs, when na >= nb > na / 2.
+//With a = a1 * B^h + a0 and b = b1 * B^h + b0, the product is a1b1 * B^2h + ((a0 + a1)(b0 + b1) - a0b0 - a1b1) * B^h + a0b0,
+//which takes three multiplications of half the size instead of four.
+static void multiplyKaratsuba(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    size_t h = (na + 1) / 2;
+    size_t high = na + nb - 2 * h;
+    uint64_t* sums = (uint64_t*)malloc((2 * h + 2 + 2 * h + 2) * sizeof(uint64_t));
+    uint64_t* sumA = sums;
+    uint64_t* sumB = sums + h + 1;
+    uint64_t* middle = sums + 2 * h + 2;
+
+    //a0b0 goes in the low 2h limbs of res, and a1b1 in the limbs above.
+    multiplyLimbs(res, a, h, b, h);
+    multiplyLimbs(res + 2 * h, a + h, na - h, b + h, nb - h);
+
+    sumA[h] = addLimbs(sumA, a, h, a + h, na - h);
+    sumB[h] = addLimbs(sumB, b, h, b + h, nb - h);
+    multiplyLimbs(middle, sumA, h + 1, sumB, h + 1);
+
+    subtractLimbs(middle, middle, 2 * h + 2, res, 2 * h);
+    subtractLimbs(middle, middle, 2 * h + 2, res + 2 * h, high);
+
+    //The middle term is a0b1 + a1b0, so the limbs above na + nb - h are 0.
+    size_t length = 2 * h + 2 < na + nb - h ? 2 * h + 2 : na + nb - h;
+    addLimbs(res + h, res + h, na + nb - h, middle, length);
+
+    free(sums);
+}
+
+//Method to make a big integer from the limbs of a between begin and end.
+static BigInt* limbSlice(const uint64_t* a, size_t na, size_t begin, size_t end) {
+    begin = begin < na ? begin : na;
+    end = end < na ? end : na;
+
+    BigInt* res = newBigInt(end - begin);
+    memcpy(res->limbs, a + begin, (end - begin) * sizeof(uint64_t));
+    res->length = end - begin;
+    trimBigInt(res);
+
+    return res;
+}
+
+//Method to divide a big integer in place by a small number that divides it.
+static void divideExact(BigInt* number, uint64_t divisor) {
+    divideSmall(number->limbs, number->limbs, number->length, divisor);
+    trimBigInt(number);
+}
+
+//Method to replace *target with value, freeing the old number.
+static void replaceBigInt(BigInt** target, BigInt* value) {
+    freeBigInt(*target);
+    *target = value;
+}
+
+//Method to multiply a by b with the Toom-3 method into res, which gets na + nb limbs, when na >= nb > na / 2.
+//Both numbers are split in three parts of k limbs, which gives polynomials of degree 2 in B^k. The product polynomial
+//of degree 4 is found from its values at 0, 1, -1, -2 and infinity, which takes five multiplications of a third of the size.
+//The values can be negative, so they are signed big integers. Interpolation follows Bodrato's sequence, where the
+//divisions by 2 and 3 are exact.
+static void multiplyToom3(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    size_t k = (na + 2) / 3;
+    BigInt* parts[6];
+    BigInt* values[10];
+
+    for (int i = 0; i < 3; i++) {
+        parts[i] = limbSlice(a, na, i * k, (i + 1) * k);
+        parts[3 + i] = limbSlice(b, nb, i * k, (i + 1) * k);
+    }
+
+    //Values of the two polynomials at 1, -1 and -2. values[i] is for a, and values[5 + i] for b.
+    for (int side = 0; side < 2; side++) {
+        BigInt** m = parts + 3 * side;
+        BigInt** v = values + 5 * side;
+        BigInt* evenSum = bigIntAdd(m[0], m[2]);
+
+        v[0] = bigIntAdd(evenSum, m[1]);
+        v[1] = bigIntSubtract(evenSum, m[1]);
+
+        BigInt* t = bigIntAdd(v[1], m[2]);
+        BigInt* doubled = bigIntAdd(t, t);
+        v[2] = bigIntSubtract(doubled, m[0]);
+
+        freeBigInt(evenSum);
+        freeBigInt(t);
+        freeBigInt(doubled);
+    }
+
+    BigInt* r0 = bigIntMultiply(parts[0], parts[3]);
+    BigInt* r1 = bigIntMultiply(values[0], values[5]);
+    BigInt* rm1 = bigIntMultiply(values[1], values[6]);
+    BigInt* rm2 = bigIntMultiply(values[2], values[7]);
+    BigInt* rInf = bigIntMultiply(parts[2], parts[5]);
+
+    for (int i = 0; i < 6; i++) {
+        freeBigInt(parts[i]);
+    }
+
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < 3; i++) {
+            freeBigInt(values[5 * side + i]);
+        }
+    }
+
+    //r3 = (r(-2) - r(1)) / 3
+    BigInt* r3 = bigIntSubtract(rm2, r1);
+    divideExact(r3, 3);
+
+    //r1 = (r(1) - r(-1)) / 2
+    replaceBigInt(&r1, bigIntSubtract(r1, rm1));
+    divideExact(r1, 2);
+
+    //r2 = r(-1) - r(0)
+    BigInt* r2 = bigIntSubtract(rm1, r0);
+
+    //r3 = (r2 - r3) / 2 + 2 * r(inf)
+    replaceBigInt(&r3, bigIntSubtract(r2, r3));
+    divideExact(r3, 2);
+    replaceBigInt(&r3, bigIntAdd(r3, rInf));
+    replaceBigInt(&r3, bigIntAdd(r3, rInf));
+
+    //r2 = r2 + r1 - r(inf)
+    replaceBigInt(&r2, bigIntAdd(r2, r1));
+    replaceBigInt(&r2, bigIntSubtract(r2, rInf));
+
+    //r1 = r1 - r3
+    replaceBigInt(&r1, bigIntSubtract(r1, r3));
+
+    //The coefficients are now the non-negative coefficients of the product, so they fit below na + nb limbs.
+    BigInt* coefficients[5] = {r0, r1, r2, r3, rInf};
+    memset(res, 0, (na + nb) * sizeof(uint64_t));
+
+    for (int i = 0; i < 5; i++) {
+        size_t offset = i * k;
+
+        if (coefficients[i]->length > 0) {
+            addLimbs(res + offset, res + offset, na + nb - offset, coefficients[i]->limbs, coefficients[i]->length);
+        }
+
+        freeBigInt(coefficients[i]);
+    }
+
+    freeBigInt(rm1);
+    freeBigInt(rm2);
+}
+
+//Structure for a prime used for NTT, with the numbers needed for Montgomery multiplication modulo the prime.
+typedef struct {
+    uint32_t mod;
+    uint32_t inverse;   //-mod^-1 modulo 2^32.
+    uint32_t r2;        //2^64 modulo mod, to bring numbers into Montgomery form.
+    uint32_t generator; //Generator of the multiplicative group modulo mod.
+} NttPrime;
+
+//Method to make an NttPrime.
+static NttPrime nttPrime(uint32_t mod, uint32_t generator) {
+    NttPrime prime;
+    uint32_t inverse = mod;
+
+    //Newton's iteration doubles the number of correct low bits each time: 3, 6, 12, 24, 48.
+    for (int i = 0; i < 4; i++) {
+        inverse *= 2 - mod * inverse;
+    }
+
+    prime.mod = mod;
+    prime.inverse = -inverse;
+    prime.r2 = (uint32_t)(((unsigned __int128)1 << 64) % mod);
+    prime.generator = generator;
+
+    return prime;
+}
+
+//Method to find a * b / 2^32 modulo the prime, for a * b < mod * 2^32.
+static inline uint32_t montgomeryMultiply(uint32_t a, uint32_t b, const NttPrime* prime) {
+    uint64_t product = (uint64_t)a * b;
+    uint32_t m = (uint32_t)product * prime->inverse;
+    uint32_t res = (uint32_t)((product + (uint64_t)m * prime->mod) >> 32);
+
+    return res >= prime->mod ? res - prime->mod : res;
+}
+
+//Method to find base^exponent in Montgomery form, where base is in Montgomery form.
+static uint32_t montgomeryPower(uint32_t base, uint64_t exponent, const NttPrime* prime) {
+    uint32_t res = montgomeryMultiply(1, prime->r2, prime);
+
+    while (exponent) {
+        if (exponent & 1) {
+            res = montgomeryMultiply(res, base, prime);
+        }
+
+        base = montgomeryMultiply(base, base, prime);
+        exponent >>= 1;
+    }
+
+    return res;
+}
+
+//Method to do an in-place number theoretic transform of n numbers in Montgomery form, where n is a power of two.
+//The inverse transform is not divided by n. roots needs room for n / 2 numbers.
+static void ntt(uint32_t* x, size_t n, const NttPrime* prime, int inverse, uint32_t* roots) {
+    uint32_t mod = prime->mod;
+
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+
+        j ^= bit;
+
+        if (i < j) {
+            uint32_t temp = x[i];
+            x[i] = x[j];
+            x[j] = temp;
+        }
+    }
+
+    uint32_t generator = montgomeryMultiply(prime->generator, prime->r2, prime);
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        size_t half = length / 2;
+        uint32_t root = montgomeryPower(generator, (mod - 1) / length, prime);
+
+        if (inverse) {
+            root = montgomeryPower(root, length - 1, prime);
+        }
+
+        roots[0] = montgomeryMultiply(1, prime->r2, prime);
+
+        for (size_t j = 1; j < half; j++) {
+            roots[j] = montgomeryMultiply(roots[j - 1], root, prime);
+        }
+
+        for (size_t i = 0; i < n; i += length) {
+            for (size_t j = 0; j < half; j++) {
+                uint32_t u = x[i + j];
+                uint32_t v = montgomeryMultiply(x[i + j + half], roots[j], prime);
+
+                x[i + j] = u + v >= mod ? u + v - mod : u + v;
+                x[i + j + half] = u >= v ? u - v : u + mod - v;
+            }
+        }
+    }
+}
+
+//Method to find the length of the transform for a product of na + nb limbs, with two base 10^9 digits per limb.
+static size_t nttLength(size_t na, size_t nb) {
+    size_t length = 1;
+
+    while (length < 2 * (na + nb)) {
+        length <<= 1;
+    }
+
+    return length;
+}
+
+//Method to find the convolution of the base 10^9 digits of a and b modulo a prime.
+static void nttConvolution(uint32_t* res, uint32_t* work, uint32_t* roots, const uint64_t* a, size_t na,
+                           const uint64_t* b, size_t nb, size_t n, const NttPrime* prime) {
+    const uint64_t* operands[2] = {a, b};
+    size_t lengths[2] = {na, nb};
+    uint32_t* transforms[2] = {res, work};
+    //Squaring needs only one forward transform.
+    int count = a == b && na == nb ? 1 : 2;
+
+    for (int side = 0; side < count; side++) {
+        uint32_t* x = transforms[side];
+
+        for (size_t i = 0; i < lengths[side]; i++) {
+            x[2 * i] = montgomeryMultiply((uint32_t)(operands[side][i] % 1000000000), prime->r2, prime);
+            x[2 * i + 1] = montgomeryMultiply((uint32_t)(operands[side][i] / 1000000000), prime->r2, prime);
+        }
+
+        memset(x + 2 * lengths[side], 0, (n - 2 * lengths[side]) * sizeof(uint32_t));
+        ntt(x, n, prime, 0, roots);
+    }
+
+    uint32_t* other = count == 1 ? res : work;
+
+    for (size_t i = 0; i < n; i++) {
+        res[i] = montgomeryMultiply(res[i], other[i], prime);
+    }
+
+    ntt(res, n, prime, 1, roots);
+
+    //Dividing by n and leaving Montgomery form in one multiplication, since montgomeryMultiply(xR, y) = xy.
+    uint32_t nInverse = 1;
+    uint64_t base = n % prime->mod;
+
+    for (uint64_t exponent = prime->mod - 2; exponent; exponent >>= 1) {
+        if (exponent & 1) {
+            nInverse = (uint32_t)(nInverse * base % prime->mod);
+        }
+
+        base = base * base % prime->mod;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        res[i] = montgomeryMultiply(res[i], nInverse, prime);
+    }
+}
+
+//Method to find x^-1 modulo a prime.
+static uint64_t inverseModulo(uint64_t x, uint64_t mod) {
+    uint64_t res = 1;
+    x %= mod;
+
+    for (uint64_t exponent = mod - 2; exponent; exponent >>= 1) {
+        if (exponent & 1) {
+            res = res * x % mod;
+        }
+
+        x = x * x % mod;
+    }
+
+    return res;
+}
+
+//Method to divide a 128-bit number by 10^9 with 64-bit divisions, which are much faster than a 128-bit division.
+static unsigned __int128 divideBillion(unsigned __int128 value, uint32_t* remainder) {
+    uint64_t high = (uint64_t)(value >> 64);
+    uint64_t low = (uint64_t)value;
+    uint64_t quotientHigh = high / 1000000000;
+    uint64_t part = ((high % 1000000000) << 32) | (low >> 32);
+    uint64_t quotientMiddle = part / 1000000000;
+    part = ((part % 1000000000) << 32) | (low & 0xFFFFFFFF);
+
+    *remainder = (uint32_t)(part % 1000000000);
+
+    return ((unsigned __int128)quotientHigh << 64) + ((unsigned __int128)quotientMiddle << 32) + part / 1000000000;
+}
+
+//Method to multiply a by b with number theoretic transforms into res, which gets na + nb limbs.
+//The limbs are split into base 10^9 digits, and the convolution of the digits is found modulo three primes below 2^30.
+//Each sum in the convolution is below (na + nb) * 10^18, far below the product of the primes (about 2^85), so the
+//Chinese remainder theorem gives the exact sums, which are then carried in base 10^9.
+static void multiplyNtt(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    NttPrime primes[3] = {nttPrime(469762049, 3), nttPrime(167772161, 3), nttPrime(754974721, 11)};
+    size_t n = nttLength(na, nb);
+    uint32_t* residues[3];
+    uint32_t* work = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint32_t* roots = (uint32_t*)malloc(n / 2 * sizeof(uint32_t));
+
+    for (int i = 0; i < 3; i++) {
+        residues[i] = (uint32_t*)malloc(n * sizeof(uint32_t));
+        nttConvolution(residues[i], work, roots, a, na, b, nb, n, &primes[i]);
+    }
+
+    uint64_t p1 = primes[0].mod;
+    uint64_t p2 = primes[1].mod;
+    uint64_t p3 = primes[2].mod;
+    uint64_t inverse12 = inverseModulo(p1, p2);
+    uint64_t inverse123 = inverseModulo(p1 * p2 % p3, p3);
+    unsigned __int128 carry = 0;
+    uint32_t digits[2];
+
+    //Garner's method: x = x1 + x2 * p1 + x3 * p1 * p2, with each xi below pi.
+    for (size_t i = 0; i < 2 * (na + nb); i++) {
+        uint64_t x1 = residues[0][i];
+        uint64_t x2 = (residues[1][i] + p2 - x1 % p2) % p2 * inverse12 % p2;
+        uint64_t x12 = (x1 + x2 * p1) % p3;
+        uint64_t x3 = (residues[2][i] + p3 - x12) % p3 * inverse123 % p3;
+        unsigned __int128 value = x1 + (unsigned __int128)x2 * p1 + (unsigned __int128)x3 * p1 * p2;
+
+        carry = divideBillion(value + carry, &digits[i & 1]);
+
+        if (i & 1) {
+            res[i / 2] = digits[0] + (uint64_t)digits[1] * 1000000000;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        free(residues[i]);
+    }
+
+    free(work);
+    free(roots);
+}
+
+//Method to multiply a by b when b is much shorter, as a sum of products of b with pieces of a as long as b.
+static void multiplyUnbalanced(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    uint64_t* piece = (uint64_t*)malloc(2 * nb * sizeof(uint64_t));
+    memset(res, 0, (na + nb) * sizeof(uint64_t));
+
+    for (size_t offset = 0; offset < na; offset += nb) {
+        size_t length = na - offset < nb ? na - offset : nb;
+        multiplyLimbs(piece, a + offset, length, b, nb);
+        addLimbs(res + offset, res + offset, na + nb - offset, piece, length + nb);
+    }
+
+    free(piece);
+}
+
+//Method to multiply a by b into res, which gets na + nb limbs, picking the method by the size of the shorter operand.
+static void multiplyLimbs(uint64_t* res, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) {
+    if (na < nb) {
+        const uint64_t* temp = a;
+        a = b;
+        b = temp;
+        size_t length = na;
+        na = nb;
+        nb = length;
+    }
+
+    if (nb == 0) {
+        memset(res, 0, na * sizeof(uint64_t));
+    } else if (nb < KARATSUBA_THRESHOLD) {
+        multiplySchoolbook(res, a, na, b, nb);
+    } else if (nb >= NTT_THRESHOLD && nttLength(na, nb) <= NTT_MAX_LENGTH) {
+        multiplyNtt(res, a, na, b, nb);
+    } else if (nb * 2 <= na) {
+        multiplyUnbalanced(res, a, na, b, nb);
+    } else if (nb < TOOM3_THRESHOLD) {
+        multiplyKaratsuba(res, a, na, b, nb);
+    } else {
+        multiplyToom3(res, a, na, b, nb);
+    }
+}
+
+//Method to multiply two big integers.
+static BigInt* bigIntMultiply(const BigInt* lhs, const BigInt* rhs) {
+    BigInt* res = newBigInt(lhs->length + rhs->length);
+
+    if (lhs->length > 0 && rhs->length > 0) {
+        multiplyLimbs(res->limbs, lhs->limbs, lhs->length, rhs->limbs, rhs->length);
+        res->length = lhs->length + rhs->length;
+        res->negative = lhs->negative != rhs->negative;
+        trimBigInt(res);
+    }
+
+    return res;
+}
+
+#endif
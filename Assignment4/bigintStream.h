@@ -0,0 +1,472 @@
+#ifndef BIGINT_STREAM_H
+#define BIGINT_STREAM_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "decimalSimd.h"
+
+//Number of digits read and written at a time when streaming. Memory use is three blocks, whatever the size of the numbers.
+#define STREAM_BLOCK_SIZE (1 << 22)
+
+//Size of the block used when scanning from the most significant digit, which usually stops after a few digits.
+#define STREAM_SCAN_SIZE (1 << 16)
+
+//Structure for a decimal number in a file: an optional '-', digits, and optional whitespace at the end.
+typedef struct {
+    int fd;
+    off_t first;        //Offset of the first digit that is not a leading zero.
+    uint64_t length;    //Number of digits from first.
+    int negative;
+    char* scan;         //Block of the file for reading single digits.
+    off_t scanStart;
+    size_t scanLength;
+} StreamOperand;
+
+//Method to read count bytes at offset, retrying short reads. Returns -1 on an error or if the file is too short.
+static int preadFully(int fd, char* buffer, size_t count, off_t offset) {
+    while (count > 0) {
+        ssize_t n = pread(fd, buffer, count, offset);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            errno = n == 0 ? EIO : errno;
+            return -1;
+        }
+
+        buffer += n;
+        count -= n;
+        offset += n;
+    }
+
+    return 0;
+}
+
+//Method to write count bytes at offset, retrying short writes.
+static int pwriteFully(int fd, const char* buffer, size_t count, off_t offset) {
+    while (count > 0) {
+        ssize_t n = pwrite(fd, buffer, count, offset);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n < 0) {
+            return -1;
+        }
+
+        buffer += n;
+        count -= n;
+        offset += n;
+    }
+
+    return 0;
+}
+
+//Method to read the byte at an offset of the operand's file, through the scan block. Returns -1 on a read error.
+static int operandByte(StreamOperand* operand, off_t offset) {
+    if (offset < operand->scanStart || offset >= operand->scanStart + (off_t)operand->scanLength) {
+        ssize_t n = pread(operand->fd, operand->scan, STREAM_SCAN_SIZE, offset);
+
+        if (n <= 0) {
+            errno = n == 0 ? EIO : errno;
+            return -1;
+        }
+
+        operand->scanStart = offset;
+        operand->scanLength = n;
+    }
+
+    return (unsigned char)operand->scan[offset - operand->scanStart];
+}
+
+//Method to get the digit at an index counted from the most significant digit of the operand.
+//Returns -1 and sets errno if the character is not a digit or could not be read.
+static int operandDigit(StreamOperand* operand, uint64_t index) {
+    int c = operandByte(operand, operand->first + index);
+
+    if (c < 0) {
+        return -1;
+    }
+
+    if (c < '0' || c > '9') {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return c - '0';
+}
+
+//Method to open a number file, find its sign and skip leading zeros and trailing whitespace.
+static int openOperand(StreamOperand* operand, const char* path) {
+    struct stat info;
+
+    operand->scan = (char*)malloc(STREAM_SCAN_SIZE);
+    operand->scanStart = 0;
+    operand->scanLength = 0;
+    operand->fd = open(path, O_RDONLY);
+
+    if (operand->fd < 0 || fstat(operand->fd, &info) < 0) {
+        return -1;
+    }
+
+    off_t end = info.st_size;
+
+    //Trailing whitespace, read backwards one byte at a time since there is usually just a newline.
+    while (end > 0) {
+        char last;
+
+        if (preadFully(operand->fd, &last, 1, end - 1) < 0) {
+            return -1;
+        }
+
+        if (last != '\n' && last != '\r' && last != ' ' && last != '\t') {
+            break;
+        }
+
+        end--;
+    }
+
+    operand->first = 0;
+    operand->negative = end > 0 && operandByte(operand, 0) == '-';
+    operand->first = operand->negative;
+
+    if (operand->first >= end) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    //Skipping leading zeros, but keeping the last digit of 0.
+    while (operand->first + 1 < end && operandByte(operand, operand->first) == '0') {
+        operand->first++;
+    }
+
+    operand->length = end - operand->first;
+
+    //-0 is 0.
+    if (operand->length == 1 && operandByte(operand, operand->first) == '0') {
+        operand->negative = 0;
+    }
+
+    return 0;
+}
+
+//Method to close a number file.
+static void closeOperand(StreamOperand* operand) {
+    if (operand->fd >= 0) {
+        close(operand->fd);
+    }
+
+    free(operand->scan);
+}
+
+//Method to get digit p of an operand, where p counts from the most significant digit of a number with width digits
+//and the operand is padded with leading zeros to that width.
+static int alignedDigit(StreamOperand* operand, uint64_t p, uint64_t width) {
+    uint64_t padding = width - operand->length;
+    return p < padding ? 0 : operandDigit(operand, p - padding);
+}
+
+//Method to get a pointer to the byte at an offset of the operand's file in the scan block, and the number of bytes
+//from there to the end of the block. Returns NULL on a read error.
+static const char* operandSpan(StreamOperand* operand, off_t offset, size_t* available) {
+    if (operandByte(operand, offset) < 0) {
+        return NULL;
+    }
+
+    *available = operand->scanStart + operand->scanLength - offset;
+    return operand->scan + (offset - operand->scanStart);
+}
+
+//Method to find the first position from p where the digits of x and y differ, padded to width digits.
+//Where both numbers have digits, whole scan blocks are compared with memcmp.
+//Returns width if there is no difference, or -1 on an error.
+static int64_t firstDifference(StreamOperand* x, StreamOperand* y, uint64_t p, uint64_t width) {
+    uint64_t paddingX = width - x->length;
+    uint64_t paddingY = width - y->length;
+
+    while (p < width) {
+        if (p < paddingX || p < paddingY) {
+            int dx = alignedDigit(x, p, width);
+            int dy = alignedDigit(y, p, width);
+
+            if (dx < 0 || dy < 0) {
+                return -1;
+            }
+
+            if (dx != dy) {
+                return p;
+            }
+
+            p++;
+            continue;
+        }
+
+        size_t availableX;
+        size_t availableY;
+        const char* spanX = operandSpan(x, x->first + (p - paddingX), &availableX);
+        const char* spanY = operandSpan(y, y->first + (p - paddingY), &availableY);
+
+        if (!spanX || !spanY) {
+            return -1;
+        }
+
+        size_t count = availableX < availableY ? availableX : availableY;
+        count = count < width - p ? count : width - p;
+
+        unsigned invalid = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            invalid |= ((unsigned char)spanX[i] - '0' > 9) | ((unsigned char)spanY[i] - '0' > 9);
+        }
+
+        if (invalid) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        if (memcmp(spanX, spanY, count) != 0) {
+            size_t i = 0;
+
+            while (spanX[i] == spanY[i]) {
+                i++;
+            }
+
+            return p + i;
+        }
+
+        p += count;
+    }
+
+    return width;
+}
+
+//Method to compare the digits of x and y from position p, padded to width digits.
+//Returns the sign of the first difference, 0 if there is none, or -2 on an error.
+static int compareFrom(StreamOperand* x, StreamOperand* y, uint64_t p, uint64_t width) {
+    int64_t q = firstDifference(x, y, p, width);
+
+    if (q < 0) {
+        return -2;
+    }
+
+    if ((uint64_t)q == width) {
+        return 0;
+    }
+
+    return alignedDigit(x, q, width) < alignedDigit(y, q, width) ? -1 : 1;
+}
+
+//Method to find the number of digits in x + y, which is one more than the longest if there is a carry out of the top.
+//The carry out is decided by the most significant position where the digits do not add up to 9.
+static int64_t sumLength(StreamOperand* x, StreamOperand* y) {
+    uint64_t width = x->length > y->length ? x->length : y->length;
+
+    for (uint64_t p = 0; p < width; p++) {
+        int dx = alignedDigit(x, p, width);
+        int dy = alignedDigit(y, p, width);
+
+        if (dx < 0 || dy < 0) {
+            return -1;
+        }
+
+        if (dx + dy != 9) {
+            return width + (dx + dy > 9);
+        }
+    }
+
+    return width;
+}
+
+//Method to find the number of digits in x - y, when x > y and x has width digits. The top p + 1 digits of the
+//difference are D - borrow, where D is the difference of the top p + 1 digits of x and y, and borrow is 1 if the rest
+//of x is smaller than the rest of y. D is 0 down to the first digit that differs and is then at least 1. Once D is 2 or
+//more the digits are not all 0 whatever the borrow is, and D only stays 1 while x has a 0 where y has a 9.
+static int64_t differenceLength(StreamOperand* x, StreamOperand* y) {
+    uint64_t width = x->length;
+    int64_t first = firstDifference(x, y, 0, width);
+
+    if (first < 0) {
+        return -1;
+    }
+
+    if ((uint64_t)first == width) {
+        return 1;
+    }
+
+    int64_t d = 0;
+
+    for (uint64_t p = first; p < width; p++) {
+        int dx = alignedDigit(x, p, width);
+        int dy = alignedDigit(y, p, width);
+
+        if (dx < 0 || dy < 0) {
+            return -1;
+        }
+
+        d = 10 * d + dx - dy;
+
+        if (d >= 2) {
+            if (p == (uint64_t)first) {
+                return width - p;
+            }
+
+            //D was 1 above p, so those digits are 0 only if the rest from p on is smaller.
+            int compare = dx != dy ? (dx < dy ? -1 : 1) : compareFrom(x, y, p + 1, width);
+
+            if (compare == -2) {
+                return -1;
+            }
+
+            return compare >= 0 ? width - p + 1 : width - p;
+        }
+    }
+
+    //x - y is 1.
+    return 1;
+}
+
+//Method to add or subtract the numbers in two files into a third file, streaming from the least significant digits.
+//op is '+' or '-'. Both numbers are read backwards in blocks with pread and the result is written backwards with pwrite,
+//with the carry or borrow kept between blocks, so memory use does not depend on the size of the numbers.
+//The digits of a block are added or subtracted with the SIMD kernels in decimalSimd.h.
+//Returns the number of digits written, or -1 with errno set (EINVAL if a file does not hold a number).
+static int64_t streamAddSubtract(const char* lhsPath, char op, const char* rhsPath, const char* outPath) {
+    StreamOperand lhs = {-1, 0, 0, 0, NULL, 0, 0};
+    StreamOperand rhs = {-1, 0, 0, 0, NULL, 0, 0};
+    char* buffers = NULL;
+    int out = -1;
+    int64_t res = -1;
+
+    if (openOperand(&lhs, lhsPath) < 0 || openOperand(&rhs, rhsPath) < 0) {
+        goto done;
+    }
+
+    //Same signs add the magnitudes, different signs subtract the smaller magnitude from the larger.
+    int rhsNegative = rhs.negative != (op == '-');
+    int subtract = lhs.negative != rhsNegative;
+    int negative = lhs.negative;
+    StreamOperand* x = &lhs;
+    StreamOperand* y = &rhs;
+    int64_t length;
+
+    if (subtract) {
+        int compare = lhs.length != rhs.length ? (lhs.length < rhs.length ? -1 : 1)
+                                                : compareFrom(&lhs, &rhs, 0, lhs.length);
+
+        if (compare == -2) {
+            goto done;
+        }
+
+        if (compare < 0) {
+            x = &rhs;
+            y = &lhs;
+            negative = rhsNegative;
+        }
+
+        negative = compare == 0 ? 0 : negative;
+        length = differenceLength(x, y);
+    } else {
+        length = sumLength(x, y);
+    }
+
+    if (length < 0) {
+        goto done;
+    }
+
+    out = open(outPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (out < 0 || ftruncate(out, negative + length + 1) < 0) {
+        goto done;
+    }
+
+    //The digits are worked on in a frame of width digits, one more than the longest number, so a carry has room.
+    uint64_t width = (x->length > y->length ? x->length : y->length) + 1;
+    uint64_t resultStart = width - length;
+    char* bufferX;
+    char* bufferY;
+    char* bufferOut;
+    int carry = 0;
+
+    buffers = (char*)malloc(3 * STREAM_BLOCK_SIZE);
+    bufferX = buffers;
+    bufferY = buffers + STREAM_BLOCK_SIZE;
+    bufferOut = buffers + 2 * STREAM_BLOCK_SIZE;
+
+    for (uint64_t high = width; high > resultStart;) {
+        uint64_t low = high - resultStart > STREAM_BLOCK_SIZE ? high - STREAM_BLOCK_SIZE : resultStart;
+        size_t count = high - low;
+        StreamOperand* operands[2] = {x, y};
+        char* blocks[2] = {bufferX, bufferY};
+
+        //Reading the part of each number in the frame positions [low, high), with '0' for the padding in front.
+        for (int i = 0; i < 2; i++) {
+            uint64_t padding = width - operands[i]->length;
+            uint64_t start = low > padding ? low : padding;
+
+            if (start >= high) {
+                memset(blocks[i], '0', count);
+                continue;
+            }
+
+            memset(blocks[i], '0', start - low);
+
+            if (preadFully(operands[i]->fd, blocks[i] + (start - low), high - start,
+                           operands[i]->first + (start - padding)) < 0) {
+                goto done;
+            }
+        }
+
+        //The digit kernels handle 32 or 64 digits per instruction, with the carry or borrow kept between blocks.
+        carry = subtract ? subtractDigits(bufferOut, bufferX, bufferY, count, carry)
+                         : addDigits(bufferOut, bufferX, bufferY, count, carry);
+
+        if (carry < 0) {
+            errno = EINVAL;
+            goto done;
+        }
+
+        if (pwriteFully(out, bufferOut, count, negative + (low - resultStart)) < 0) {
+            goto done;
+        }
+
+        high = low;
+    }
+
+    if ((negative && pwriteFully(out, "-", 1, 0) < 0) || pwriteFully(out, "\n", 1, negative + length) < 0) {
+        goto done;
+    }
+
+    res = length;
+
+done:
+    {
+        int error = errno;
+
+        if (out >= 0 && close(out) < 0 && res >= 0) {
+            error = errno;
+            res = -1;
+        }
+
+        if (res < 0 && out >= 0) {
+            unlink(outPath);
+        }
+
+        closeOperand(&lhs);
+        closeOperand(&rhs);
+        free(buffers);
+        errno = error;
+    }
+
+    return res;
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef CONCURRENT_WORD_SET_H
+#define CONCURRENT_WORD_SET_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+// Highest number of levels in the skip list. With a quarter of the nodes on
+// each level going up a level, 16 levels are enough for 4^16 words.
+#define SKIP_LIST_LEVELS 16
+
+// Structure for a node in the skip list. The node is allocated with room for
+// height next pointers.
+typedef struct SkipNodeStruct {
+  const char *word;
+  int height;
+  std::atomic<struct SkipNodeStruct *> next[1];
+} SkipNode;
+
+// Ordered set of words that many threads can insert into and search at the
+// same time, as a lock-free skip list. A new node is published with one
+// compare-and-swap on the bottom level, which is what decides if the word is
+// in the set, and is then linked into the levels above. Readers only follow
+// pointers and never wait for writers. Words are never removed, so a node is
+// never freed while another thread can reach it, and no reclamation scheme
+// (hazard pointers or epochs) is needed until the set is destroyed.
+class ConcurrentWordSet {
+  SkipNode *head;
+  std::atomic<long long> count;
+
+  static SkipNode *newSkipNode(const char *word, int height) {
+    size_t size = sizeof(SkipNode) + (height - 1) * sizeof(std::atomic<SkipNode *>);
+    SkipNode *node = (SkipNode *)::operator new(size);
+
+    node->word = word;
+    node->height = height;
+
+    for (int level = 0; level < height; level++) {
+      new (&node->next[level]) std::atomic<SkipNode *>(nullptr);
+    }
+
+    return node;
+  }
+
+  // Method to pick the height of a new node: 1 with probability 3/4, 2 with
+  // probability 3/16, and so on.
+  static int randomHeight() {
+    thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ (uint64_t)(uintptr_t)&state;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    int height = 1;
+    uint64_t bits = state;
+
+    while (height < SKIP_LIST_LEVELS && (bits & 3) == 0) {
+      height++;
+      bits >>= 2;
+    }
+
+    return height;
+  }
+
+  // Method to find, on every level, the last node before word (preds) and the
+  // node after it (succs). Returns true if the word is in the set.
+  bool find(const char *word, SkipNode **preds, SkipNode **succs) const {
+    SkipNode *pred = this->head;
+
+    for (int level = SKIP_LIST_LEVELS - 1; level >= 0; level--) {
+      SkipNode *current = pred->next[level].load(std::memory_order_acquire);
+
+      while (current && strcmp(current->word, word) < 0) {
+        pred = current;
+        current = pred->next[level].load(std::memory_order_acquire);
+      }
+
+      preds[level] = pred;
+      succs[level] = current;
+    }
+
+    return succs[0] && strcmp(succs[0]->word, word) == 0;
+  }
+
+ public:
+  // Iterator over the words in alphabetical order. Words inserted while
+  // iterating may or may not be seen.
+  class Iterator {
+    const SkipNode *node;
+
+   public:
+    Iterator(const SkipNode *node) : node(node) {}
+
+    const char *operator*() const { return this->node->word; }
+
+    Iterator &operator++() {
+      this->node = this->node->next[0].load(std::memory_order_acquire);
+      return *this;
+    }
+
+    bool operator!=(const Iterator &other) const {
+      return this->node != other.node;
+    }
+  };
+
+  ConcurrentWordSet() : head(newSkipNode(NULL, SKIP_LIST_LEVELS)), count(0) {}
+
+  ~ConcurrentWordSet() {
+    SkipNode *node = this->head;
+
+    while (node) {
+      SkipNode *next = node->next[0].load(std::memory_order_relaxed);
+      ::operator delete(node);
+      node = next;
+    }
+  }
+
+  ConcurrentWordSet(const ConcurrentWordSet &) = delete;
+  ConcurrentWordSet &operator=(const ConcurrentWordSet &) = delete;
+
+  // Insert a word. The set keeps a pointer to the word, so it must live as
+  // long as the set. Returns false if the word was already in the set.
+  bool insert(const char *word) {
+    SkipNode *preds[SKIP_LIST_LEVELS];
+    SkipNode *succs[SKIP_LIST_LEVELS];
+    SkipNode *node = NULL;
+
+    for (;;) {
+      if (find(word, preds, succs)) {
+        // Another thread inserted the word first.
+        if (node) {
+          ::operator delete(node);
+        }
+
+        return false;
+      }
+
+      if (!node) {
+        node = newSkipNode(word, randomHeight());
+      }
+
+      for (int level = 0; level < node->height; level++) {
+        node->next[level].store(succs[level], std::memory_order_relaxed);
+      }
+
+      // Publishing the node on the bottom level. If another node was linked in
+      // at this place first, the search is done again.
+      SkipNode *expected = succs[0];
+
+      if (preds[0]->next[0].compare_exchange_strong(expected, node, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    // The word is now in the set. The levels above only make later searches
+    // faster, and are linked one at a time, searching again on conflicts.
+    // The next pointer is set again before every compare-and-swap, since a
+    // search after a conflict on a lower level can find new successors here.
+    for (int level = 1; level < node->height; level++) {
+      for (;;) {
+        SkipNode *expected = succs[level];
+        node->next[level].store(expected, std::memory_order_relaxed);
+
+        if (preds[level]->next[level].compare_exchange_strong(expected, node, std::memory_order_release,
+                                                              std::memory_order_relaxed)) {
+          break;
+        }
+
+        find(word, preds, succs);
+      }
+    }
+
+    this->count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool contains(const char *word) const {
+    const SkipNode *pred = this->head;
+
+    for (int level = SKIP_LIST_LEVELS - 1; level >= 0; level--) {
+      const SkipNode *current = pred->next[level].load(std::memory_order_acquire);
+
+      while (current) {
+        int compare = strcmp(current->word, word);
+
+        if (compare == 0) {
+          return true;
+        }
+
+        if (compare > 0) {
+          break;
+        }
+
+        pred = current;
+        current = pred->next[level].load(std::memory_order_acquire);
+      }
+    }
+
+    return false;
+  }
+
+  // Method to get the number of words in the set.
+  long long size() const { return this->count.load(std::memory_order_relaxed); }
+
+  Iterator begin() const { return Iterator(this->head->next[0].load(std::memory_order_acquire)); }
+
+  Iterator end() const { return Iterator(NULL); }
+};
+
+#endif
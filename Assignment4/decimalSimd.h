@@ -0,0 +1,263 @@
+#ifndef DECIMAL_SIMD_H
+#define DECIMAL_SIMD_H
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//Adding and subtracting numbers stored as ASCII digits, most significant digit first, many digits per instruction.
+//The digit sums (or differences) of a whole vector are found at once. Then each digit either generates a carry (sum
+//above 9), propagates one (sum of 9) or stops one. The carries into every digit are then found at once with a
+//carry-lookahead trick: with the generate and propagate bits as masks G and P, the carry chain is the same as the one
+//in the binary addition (G | P) + G + carry, so the carry into each digit is a bit of P ^ ((G | P) + G + carry).
+//Subtraction is the same with borrows, where a negative difference generates a borrow and a difference of 0 propagates one.
+//The vectors are reversed before taking the masks, so the least significant digit is bit 0 and carries move up.
+
+//Level of SIMD instructions used by addDigits and subtractDigits: 0 is scalar, 1 is AVX2 and 2 is AVX-512.
+//-1 until it is found from the CPU.
+static int decimalSimdLevel = -1;
+
+//Method to add count digits of x and y into out, from the least significant digit, with a carry in.
+//Returns the carry out, or -1 if a byte is not a digit.
+static int addDigitsScalar(char* out, const char* x, const char* y, size_t count, int carry) {
+    unsigned invalid = 0;
+
+    for (size_t i = count; i-- > 0;) {
+        unsigned dx = (unsigned char)x[i] - '0';
+        unsigned dy = (unsigned char)y[i] - '0';
+        int sum = (int)(dx + dy) + carry;
+
+        invalid |= (dx > 9) | (dy > 9);
+        carry = sum > 9;
+        out[i] = (char)('0' + sum - (carry ? 10 : 0));
+    }
+
+    return invalid ? -1 : carry;
+}
+
+//Method to subtract count digits of y from x into out, from the least significant digit, with a borrow in.
+//Returns the borrow out, or -1 if a byte is not a digit.
+static int subtractDigitsScalar(char* out, const char* x, const char* y, size_t count, int borrow) {
+    unsigned invalid = 0;
+
+    for (size_t i = count; i-- > 0;) {
+        unsigned dx = (unsigned char)x[i] - '0';
+        unsigned dy = (unsigned char)y[i] - '0';
+        int difference = (int)dx - (int)dy - borrow;
+
+        invalid |= (dx > 9) | (dy > 9);
+        borrow = difference < 0;
+        out[i] = (char)('0' + difference + (borrow ? 10 : 0));
+    }
+
+    return invalid ? -1 : borrow;
+}
+
+//Method to reverse the 32 bytes of a vector.
+__attribute__((target("avx2"), always_inline))
+static inline __m256i reverseBytesAvx2(__m256i v) {
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse), 0x4E);
+}
+
+//Method to turn the 32 bits of a mask into 32 bytes of 0 or 1.
+__attribute__((target("avx2"), always_inline))
+static inline __m256i maskToBytesAvx2(uint32_t mask) {
+    const __m256i spread = _mm256_setr_epi64x(0, 0x0101010101010101, 0x0202020202020202, 0x0303030303030303);
+    const __m256i bits = _mm256_set1_epi64x((long long)0x8040201008040201);
+    __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32((int)mask), spread);
+
+    return _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits), _mm256_set1_epi8(1));
+}
+
+//Method to add digits 32 at a time with AVX2. The digits above the last whole vector are added with the scalar method.
+__attribute__((target("avx2")))
+static int addDigitsAvx2(char* out, const char* x, const char* y, size_t count, int carry) {
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i ten = _mm256_set1_epi8(10);
+    __m256i largest = _mm256_setzero_si256();
+    size_t i = count;
+
+    while (i >= 32) {
+        i -= 32;
+
+        __m256i dx = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(x + i)), zero);
+        __m256i dy = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(y + i)), zero);
+        largest = _mm256_max_epu8(largest, _mm256_max_epu8(dx, dy));
+
+        __m256i sum = reverseBytesAvx2(_mm256_add_epi8(dx, dy));
+        uint64_t generate = (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(sum, nine));
+        uint64_t propagate = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(sum, nine));
+        uint64_t chain = (generate | propagate) + generate + (uint64_t)carry;
+
+        sum = _mm256_add_epi8(sum, maskToBytesAvx2((uint32_t)(chain ^ propagate)));
+        sum = _mm256_sub_epi8(sum, _mm256_and_si256(_mm256_cmpgt_epi8(sum, nine), ten));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi8(reverseBytesAvx2(sum), zero));
+
+        carry = (int)(chain >> 32);
+    }
+
+    int invalid = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(largest, nine), nine)) != -1;
+    carry = addDigitsScalar(out, x, y, i, carry);
+
+    return invalid ? -1 : carry;
+}
+
+//Method to subtract digits 32 at a time with AVX2.
+__attribute__((target("avx2")))
+static int subtractDigitsAvx2(char* out, const char* x, const char* y, size_t count, int borrow) {
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i ten = _mm256_set1_epi8(10);
+    __m256i largest = _mm256_setzero_si256();
+    size_t i = count;
+
+    while (i >= 32) {
+        i -= 32;
+
+        __m256i dx = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(x + i)), zero);
+        __m256i dy = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(y + i)), zero);
+        largest = _mm256_max_epu8(largest, _mm256_max_epu8(dx, dy));
+
+        __m256i difference = reverseBytesAvx2(_mm256_sub_epi8(dx, dy));
+        uint64_t generate = (uint32_t)_mm256_movemask_epi8(difference);
+        uint64_t propagate =
+            (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(difference, _mm256_setzero_si256()));
+        uint64_t chain = (generate | propagate) + generate + (uint64_t)borrow;
+
+        difference = _mm256_sub_epi8(difference, maskToBytesAvx2((uint32_t)(chain ^ propagate)));
+        difference = _mm256_add_epi8(
+            difference, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_setzero_si256(), difference), ten));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi8(reverseBytesAvx2(difference), zero));
+
+        borrow = (int)(chain >> 32);
+    }
+
+    int invalid = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(largest, nine), nine)) != -1;
+    borrow = subtractDigitsScalar(out, x, y, i, borrow);
+
+    return invalid ? -1 : borrow;
+}
+
+//Method to reverse the 64 bytes of a vector.
+__attribute__((target("avx512bw"), always_inline))
+static inline __m512i reverseBytesAvx512(__m512i v) {
+    const __m512i reverse = _mm512_set_epi64(0x0001020304050607, 0x08090A0B0C0D0E0F, 0x0001020304050607,
+                                             0x08090A0B0C0D0E0F, 0x0001020304050607, 0x08090A0B0C0D0E0F,
+                                             0x0001020304050607, 0x08090A0B0C0D0E0F);
+    const __m512i lanes = _mm512_set_epi64(1, 0, 3, 2, 5, 4, 7, 6);
+
+    return _mm512_permutexvar_epi64(lanes, _mm512_shuffle_epi8(v, reverse));
+}
+
+//Method to add digits 64 at a time with AVX-512, where the masks come straight from the compares and the carries are
+//added with a masked add.
+__attribute__((target("avx512bw")))
+static int addDigitsAvx512(char* out, const char* x, const char* y, size_t count, int carry) {
+    const __m512i zero = _mm512_set1_epi8('0');
+    const __m512i nine = _mm512_set1_epi8(9);
+    const __m512i ten = _mm512_set1_epi8(10);
+    const __m512i one = _mm512_set1_epi8(1);
+    __mmask64 invalid = 0;
+    size_t i = count;
+
+    while (i >= 64) {
+        i -= 64;
+
+        __m512i dx = _mm512_sub_epi8(_mm512_loadu_si512(x + i), zero);
+        __m512i dy = _mm512_sub_epi8(_mm512_loadu_si512(y + i), zero);
+        invalid |= _mm512_cmpgt_epu8_mask(dx, nine) | _mm512_cmpgt_epu8_mask(dy, nine);
+
+        __m512i sum = reverseBytesAvx512(_mm512_add_epi8(dx, dy));
+        uint64_t generate = _mm512_cmpgt_epu8_mask(sum, nine);
+        uint64_t propagate = _mm512_cmpeq_epu8_mask(sum, nine);
+        unsigned __int128 chain = (unsigned __int128)(generate | propagate) + generate + (unsigned)carry;
+
+        sum = _mm512_mask_add_epi8(sum, (__mmask64)((uint64_t)chain ^ propagate), sum, one);
+        sum = _mm512_mask_sub_epi8(sum, _mm512_cmpgt_epu8_mask(sum, nine), sum, ten);
+        _mm512_storeu_si512(out + i, _mm512_add_epi8(reverseBytesAvx512(sum), zero));
+
+        carry = (int)(chain >> 64);
+    }
+
+    carry = addDigitsScalar(out, x, y, i, carry);
+
+    return invalid ? -1 : carry;
+}
+
+//Method to subtract digits 64 at a time with AVX-512.
+__attribute__((target("avx512bw")))
+static int subtractDigitsAvx512(char* out, const char* x, const char* y, size_t count, int borrow) {
+    const __m512i zero = _mm512_set1_epi8('0');
+    const __m512i nine = _mm512_set1_epi8(9);
+    const __m512i ten = _mm512_set1_epi8(10);
+    const __m512i one = _mm512_set1_epi8(1);
+    __mmask64 invalid = 0;
+    size_t i = count;
+
+    while (i >= 64) {
+        i -= 64;
+
+        __m512i dx = _mm512_sub_epi8(_mm512_loadu_si512(x + i), zero);
+        __m512i dy = _mm512_sub_epi8(_mm512_loadu_si512(y + i), zero);
+        invalid |= _mm512_cmpgt_epu8_mask(dx, nine) | _mm512_cmpgt_epu8_mask(dy, nine);
+
+        __m512i difference = reverseBytesAvx512(_mm512_sub_epi8(dx, dy));
+        uint64_t generate = _mm512_movepi8_mask(difference);
+        uint64_t propagate = _mm512_cmpeq_epi8_mask(difference, _mm512_setzero_si512());
+        unsigned __int128 chain = (unsigned __int128)(generate | propagate) + generate + (unsigned)borrow;
+
+        difference = _mm512_mask_sub_epi8(difference, (__mmask64)((uint64_t)chain ^ propagate), difference, one);
+        difference = _mm512_mask_add_epi8(difference, _mm512_movepi8_mask(difference), difference, ten);
+        _mm512_storeu_si512(out + i, _mm512_add_epi8(reverseBytesAvx512(difference), zero));
+
+        borrow = (int)(chain >> 64);
+    }
+
+    borrow = subtractDigitsScalar(out, x, y, i, borrow);
+
+    return invalid ? -1 : borrow;
+}
+
+//Method to find the widest instructions the CPU supports.
+static int findDecimalSimdLevel() {
+    if (decimalSimdLevel < 0) {
+        decimalSimdLevel = __builtin_cpu_supports("avx512bw") ? 2 : (__builtin_cpu_supports("avx2") ? 1 : 0);
+    }
+
+    return decimalSimdLevel;
+}
+
+//Method to add count ASCII digits of x and y into out with a carry in, using the widest instructions the CPU supports.
+//out may be x or y. Returns the carry out, or -1 if a byte is not a digit.
+static int addDigits(char* out, const char* x, const char* y, size_t count, int carry) {
+    switch (findDecimalSimdLevel()) {
+    case 2:
+        return addDigitsAvx512(out, x, y, count, carry);
+
+    case 1:
+        return addDigitsAvx2(out, x, y, count, carry);
+
+    default:
+        return addDigitsScalar(out, x, y, count, carry);
+    }
+}
+
+//Method to subtract count ASCII digits of y from x into out with a borrow in, using the widest instructions the CPU
+//supports. out may be x or y. Returns the borrow out, or -1 if a byte is not a digit.
+static int subtractDigits(char* out, const char* x, const char* y, size_t count, int borrow) {
+    switch (findDecimalSimdLevel()) {
+    case 2:
+        return subtractDigitsAvx512(out, x, y, count, borrow);
+
+    case 1:
+        return subtractDigitsAvx2(out, x, y, count, borrow);
+
+    default:
+        return subtractDigitsScalar(out, x, y, count, borrow);
+    }
+}
+
+#endif
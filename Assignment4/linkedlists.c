@@ -1,5 +1,19 @@
+//clock_gettime, CLOCK_MONOTONIC and the pread, pwrite and ftruncate used by bigintStream.h are POSIX, so they are not
+//declared under -std=c11 without this.
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "../Benchmark/benchmark.h"
+#include "bigint.h"
+#include "bigintDivide.h"
+#include "bigintMultiply.h"
+#include "bigintStream.h"
 
 //Method to find which number is the longest (has most digits).
 int max(int a, int b) {
@@ -279,34 +293,637 @@ Number* subtract(Number* lhs, Number* rhs) {
     return difference;
 }
 
+//Method to free a number and its digits.
+void freeNumber(Number* number) {
+    Digit* digit = number->first;
+
+    while (digit) {
+        Digit* next = digit->next;
+        free(digit);
+        digit = next;
+    }
+
+    free(number);
+}
+
+//Method to check if a number has the same value as a big integer. Leading zeros in the number are skipped.
+int sameValue(Number* number, BigInt* big) {
+    char* string = bigIntToString(big);
+    char* position = string;
+    Digit* digit = number->first;
+
+    while (digit && digit->next && digit->value == 0) {
+        digit = digit->next;
+    }
+
+    while (digit && *position && *position - '0' == digit->value) {
+        digit = digit->next;
+        position++;
+    }
+
+    int same = !digit && !*position;
+    free(string);
+
+    return same;
+}
+
+//Method to get the time in seconds.
+double seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+//Method to make a random number with a number of digits, where the first digit is between low and high.
+char* randomDigits(int digits, char low, char high) {
+    char* string = (char*)malloc(digits + 1);
+
+    string[0] = low + rand() % (high - low + 1);
+
+    for (int i = 1; i < digits; i++) {
+        string[i] = '0' + rand() % 10;
+    }
+
+    string[digits] = 0;
+    return string;
+}
+
+//Number of operations timed by benchmark().
+#define BENCHMARK_OPERATIONS 7
+
+//Operands of the operations timed by benchmark(), and the results of the last time an operation was run.
+typedef struct {
+    char* lhsString;
+    char* rhsString;
+    Number* lhs;
+    Number* rhs;
+    BigInt* bigLhs;
+    BigInt* bigRhs;
+    BigInt* bigSum;
+    Number* numbers[2];
+    BigInt* bigInts[2];
+    char* printed;
+} OperationBenchmark;
+
+//Method to free the results of the last time an operation was run. It is called before each run, and is not timed.
+void freeOperationResults(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+
+    for (int i = 0; i < 2; i++) {
+        if (operation->numbers[i]) {
+            freeNumber(operation->numbers[i]);
+            operation->numbers[i] = NULL;
+        }
+
+        if (operation->bigInts[i]) {
+            freeBigInt(operation->bigInts[i]);
+            operation->bigInts[i] = NULL;
+        }
+    }
+
+    free(operation->printed);
+    operation->printed = NULL;
+}
+
+void parseNumbers(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+    operation->numbers[0] = fromString(operation->lhsString);
+    operation->numbers[1] = fromString(operation->rhsString);
+}
+
+void addNumbers(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+    operation->numbers[0] = add(operation->lhs, operation->rhs);
+}
+
+void subtractNumbers(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+    operation->numbers[0] = subtract(operation->lhs, operation->rhs);
+}
+
+void parseBigInts(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+    operation->bigInts[0] = bigIntFromString(operation->lhsString);
+    operation->bigInts[1] = bigIntFromString(operation->rhsString);
+}
+
+void addBigInts(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+    operation->bigInts[0] = bigIntAdd(operation->bigLhs, operation->bigRhs);
+}
+
+void subtractBigInts(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+    operation->bigInts[0] = bigIntSubtract(operation->bigLhs, operation->bigRhs);
+}
+
+void bigIntsToString(void* context) {
+    OperationBenchmark* operation = (OperationBenchmark*)context;
+    operation->printed = bigIntToString(operation->bigSum);
+}
+
+//Method to compare the linked list numbers with the big integers, on two random numbers with a number of digits.
+//lhs is always larger than rhs, since subtract for Number needs that. Each operation is timed with the benchmark
+//harness, on the same operands every time. The results are written as JSON if jsonFile is not NULL.
+//Returns 0 if the JSON file could not be written.
+int benchmark(int digits, const char* jsonFile) {
+    const char* names[BENCHMARK_OPERATIONS] = {"Linked list parse", "Linked list add", "Linked list subtract",
+                                               "BigInt parse", "BigInt add", "BigInt subtract", "BigInt print"};
+    void (*operations[BENCHMARK_OPERATIONS])(void*) = {parseNumbers, addNumbers, subtractNumbers, parseBigInts,
+                                                       addBigInts, subtractBigInts, bigIntsToString};
+    BenchmarkResult results[BENCHMARK_OPERATIONS];
+    OperationBenchmark operation;
+
+    memset(&operation, 0, sizeof(operation));
+    operation.lhsString = randomDigits(digits, '5', '9');
+    operation.rhsString = randomDigits(digits, '1', '4');
+    operation.lhs = fromString(operation.lhsString);
+    operation.rhs = fromString(operation.rhsString);
+    operation.bigLhs = bigIntFromString(operation.lhsString);
+    operation.bigRhs = bigIntFromString(operation.rhsString);
+
+    Number* sum = add(operation.lhs, operation.rhs);
+    Number* difference = subtract(operation.lhs, operation.rhs);
+    BigInt* bigDifference = bigIntSubtract(operation.bigLhs, operation.bigRhs);
+    operation.bigSum = bigIntAdd(operation.bigLhs, operation.bigRhs);
+
+    if (!sameValue(sum, operation.bigSum) || !sameValue(difference, bigDifference)) {
+        printf("The linked list and the BigInt results are different.\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < BENCHMARK_OPERATIONS; i++) {
+        char name[BENCHMARK_NAME_LENGTH];
+        snprintf(name, sizeof(name), "%s, %d digits", names[i], digits);
+        results[i] = runBenchmark(name, freeOperationResults, operations[i], &operation, defaultBenchmarkOptions());
+    }
+
+    freeOperationResults(&operation);
+
+    printf("%d digits, median of %d samples\n", digits, results[0].samples);
+    printf("%-12s %12s %12s %12s %14s\n", "Type", "Parse (ms)", "Add (ms)", "Subtract (ms)", "Bytes/digit");
+    printf("%-12s %12.3f %12.3f %12.3f %14.2f\n", "Linked list", results[0].median / 1e6, results[1].median / 1e6,
+           results[2].median / 1e6, (double)(digits * sizeof(Digit) + sizeof(Number)) / digits);
+    printf("%-12s %12.3f %12.3f %12.3f %14.2f\n", "BigInt", results[3].median / 1e6, results[4].median / 1e6,
+           results[5].median / 1e6, (double)(operation.bigLhs->capacity * sizeof(uint64_t) + sizeof(BigInt)) / digits);
+    printf("Printing the sum as a BigInt: %.3f ms\n", results[6].median / 1e6);
+
+    free(operation.lhsString);
+    free(operation.rhsString);
+    freeNumber(operation.lhs);
+    freeNumber(operation.rhs);
+    freeNumber(sum);
+    freeNumber(difference);
+    freeBigInt(operation.bigLhs);
+    freeBigInt(operation.bigRhs);
+    freeBigInt(operation.bigSum);
+    freeBigInt(bigDifference);
+
+    return !jsonFile || writeBenchmarkJson(results, BENCHMARK_OPERATIONS, jsonFile);
+}
+
+//Method to fill n limbs with random numbers below LIMB_BASE, where the top limb is not 0.
+void randomLimbs(uint64_t* limbs, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint64_t value = ((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^ (uint64_t)rand();
+        limbs[i] = value % LIMB_BASE;
+    }
+
+    if (limbs[n - 1] == 0) {
+        limbs[n - 1] = 1;
+    }
+}
+
+typedef void (*MultiplyMethod)(uint64_t*, const uint64_t*, size_t, const uint64_t*, size_t);
+
+//Operands of a multiplication or division timed by benchmarkThresholds().
+typedef struct {
+    MultiplyMethod multiply;
+    const uint64_t* a;
+    const uint64_t* b;
+    uint64_t* res;
+    size_t n;
+    int newton;
+    BigInt* u;
+    BigInt* v;
+    BigInt* quotient;
+    BigInt* remainder;
+} ThresholdBenchmark;
+
+void multiplyOperands(void* context) {
+    ThresholdBenchmark* operands = (ThresholdBenchmark*)context;
+    operands->multiply(operands->res, operands->a, operands->n, operands->b, operands->n);
+}
+
+void divideOperands(void* context) {
+    ThresholdBenchmark* operands = (ThresholdBenchmark*)context;
+
+    if (operands->newton) {
+        divideNewton(operands->quotient, operands->remainder, operands->u, operands->v);
+    } else {
+        divideSchoolbook(operands->quotient->limbs, operands->remainder->limbs, operands->u->limbs,
+                         2 * operands->n, operands->v->limbs, operands->n);
+    }
+}
+
+//Method to find the crossovers between the multiplication and division methods. Each method is used at the top level,
+//and its smaller multiplications use the method picked by the thresholds. The tables show the median time of each
+//method, and all the results are written as JSON if jsonFile is not NULL. Returns 0 if the JSON file could not be written.
+int benchmarkThresholds(const char* jsonFile) {
+    const char* names[4] = {"Schoolbook", "Karatsuba", "Toom-3", "NTT"};
+    MultiplyMethod methods[4] = {multiplySchoolbook, multiplyKaratsuba, multiplyToom3, multiplyNtt};
+    //Largest number of limbs each multiplication and division method is timed at, so the slow methods do not take too long.
+    size_t limits[4] = {4096, 65536, 65536, NTT_MAX_LENGTH / 4};
+    size_t divideLimits[2] = {8192, 65536};
+    size_t sizes[] = {8, 16, 24, 32, 48, 64, 96, 128, 160, 192, 256, 384, 512, 640, 768, 1024, 1536, 2048, 4096,
+                      8192, 16384, 65536, 262144};
+    size_t count = sizeof(sizes) / sizeof(sizes[0]);
+    //A short warmup and 10 samples for each method and size, so the tables do not take too long.
+    BenchmarkOptions options = {0.02, 0.005, 10};
+    BenchmarkResult* results = (BenchmarkResult*)malloc(6 * count * sizeof(BenchmarkResult));
+    int resultCount = 0;
+    ThresholdBenchmark operands;
+    char name[BENCHMARK_NAME_LENGTH];
+
+    printf("Multiplication of two numbers of n limbs (%d digits each), median microseconds\n", LIMB_DIGITS);
+    printf("%8s", "n");
+
+    for (int m = 0; m < 4; m++) {
+        printf(" %14s", names[m]);
+    }
+
+    printf("\n");
+
+    for (size_t s = 0; s < count; s++) {
+        size_t n = sizes[s];
+        uint64_t* a = (uint64_t*)malloc(4 * n * sizeof(uint64_t));
+        uint64_t* b = a + n;
+        uint64_t* res = a + 2 * n;
+
+        randomLimbs(a, n);
+        randomLimbs(b, n);
+        printf("%8zu", n);
+        memset(&operands, 0, sizeof(operands));
+        operands.a = a;
+        operands.b = b;
+        operands.res = res;
+        operands.n = n;
+
+        for (int m = 0; m < 4; m++) {
+            if (n <= limits[m]) {
+                operands.multiply = methods[m];
+                snprintf(name, sizeof(name), "%s multiplication, %zu limbs", names[m], n);
+                results[resultCount] = runBenchmark(name, NULL, multiplyOperands, &operands, options);
+                printf(" %14.2f", results[resultCount++].median / 1e3);
+            } else {
+                printf(" %14s", "-");
+            }
+        }
+
+        printf("\n");
+        free(a);
+    }
+
+    printf("\nDivision of 2n limbs by n limbs, median microseconds\n");
+    printf("%8s %14s %14s\n", "n", "Schoolbook", "Newton");
+
+    for (size_t s = 0; s < count && sizes[s] <= divideLimits[1]; s++) {
+        size_t n = sizes[s];
+        BigInt* u = newBigInt(2 * n);
+        BigInt* v = newBigInt(n);
+        BigInt* quotient = newBigInt(n + 1);
+        BigInt* remainder = newBigInt(n);
+        const char* divideNames[2] = {"Schoolbook", "Newton"};
+
+        randomLimbs(u->limbs, 2 * n);
+        randomLimbs(v->limbs, n);
+        u->length = 2 * n;
+        v->length = n;
+        memset(&operands, 0, sizeof(operands));
+        operands.n = n;
+        operands.u = u;
+        operands.v = v;
+        operands.quotient = quotient;
+        operands.remainder = remainder;
+        printf("%8zu", n);
+
+        for (int m = 0; m < 2; m++) {
+            if (n > divideLimits[m]) {
+                printf(" %14s", "-");
+                continue;
+            }
+
+            operands.newton = m;
+            snprintf(name, sizeof(name), "%s division, %zu by %zu limbs", divideNames[m], 2 * n, n);
+            results[resultCount] = runBenchmark(name, NULL, divideOperands, &operands, options);
+            printf(" %14.2f", results[resultCount++].median / 1e3);
+        }
+
+        printf("\n");
+
+        freeBigInt(u);
+        freeBigInt(v);
+        freeBigInt(quotient);
+        freeBigInt(remainder);
+    }
+
+    printf("\nThresholds: Karatsuba %d, Toom-3 %d, NTT %d, Newton %d limbs\n", KARATSUBA_THRESHOLD, TOOM3_THRESHOLD,
+           NTT_THRESHOLD, NEWTON_THRESHOLD);
+
+    int written = !jsonFile || writeBenchmarkJson(results, resultCount, jsonFile);
+    free(results);
+
+    return written;
+}
+
+//Method to write the digits of a number as ASCII, with any leading zeros it has.
+void numberDigits(Number* number, char* out) {
+    for (Digit* digit = number->first; digit; digit = digit->next) {
+        *out++ = '0' + digit->value;
+    }
+
+    *out = 0;
+}
+
+//Method to make random digits for checking carries and borrows. Mostly 9s makes long carry chains, and mostly 0s long
+//borrow chains.
+void randomPattern(char* digits, int count, int pattern) {
+    for (int i = 0; i < count; i++) {
+        int random = rand() % 10;
+
+        if (pattern == 1 && rand() % 8) {
+            random = 9;
+        } else if (pattern == 2 && rand() % 8) {
+            random = 0;
+        }
+
+        digits[i] = '0' + random;
+    }
+
+    digits[count] = 0;
+}
+
+typedef int (*DigitKernel)(char*, const char*, const char*, size_t, int);
+
+//Operands of a digit kernel timed by verifyDigitKernels().
+typedef struct {
+    DigitKernel kernel;
+    char* out;
+    const char* x;
+    const char* y;
+    size_t digits;
+} KernelBenchmark;
+
+void runDigitKernel(void* context) {
+    KernelBenchmark* operands = (KernelBenchmark*)context;
+    operands->kernel(operands->out, operands->x, operands->y, operands->digits, 0);
+}
+
+//Method to check the SIMD digit kernels against add and subtract for Number on random pairs of numbers, and to time
+//the kernels. The right hand side is padded with zeros to the length of the left hand side, and is at most as large,
+//since subtract needs that.
+void verifyDigitKernels(int pairs) {
+    const char* names[3] = {"Scalar", "AVX2", "AVX-512"};
+    DigitKernel adders[3] = {addDigitsScalar, addDigitsAvx2, addDigitsAvx512};
+    DigitKernel subtracters[3] = {subtractDigitsScalar, subtractDigitsAvx2, subtractDigitsAvx512};
+    int levels = findDecimalSimdLevel() + 1;
+    int maxDigits = 400;
+    char* lhsString = (char*)malloc(maxDigits + 1);
+    char* rhsString = (char*)malloc(maxDigits + 1);
+    char* padded = (char*)malloc(maxDigits + 1);
+    char* expected = (char*)malloc(maxDigits + 2);
+    char* res = (char*)malloc(maxDigits + 2);
+
+    for (int pair = 0; pair < pairs; pair++) {
+        int lhsDigits = 1 + rand() % maxDigits;
+        int rhsDigits = 1 + rand() % lhsDigits;
+        int pattern = rand() % 4;
+
+        randomPattern(lhsString, lhsDigits, pattern == 3 ? 0 : pattern);
+        randomPattern(rhsString, rhsDigits, pattern == 1 ? 2 : pattern);
+
+        //Pattern 3 changes one digit of the left hand side, so the borrow comes from far below.
+        if (pattern == 3) {
+            memcpy(rhsString, lhsString, (rhsDigits = lhsDigits) + 1);
+            rhsString[rand() % rhsDigits] = '0' + rand() % 10;
+        }
+
+        memset(padded, '0', lhsDigits - rhsDigits);
+        memcpy(padded + lhsDigits - rhsDigits, rhsString, rhsDigits + 1);
+
+        //Leading zeros can make the right hand side larger, and then the two sides are swapped.
+        if (strcmp(lhsString, padded) < 0) {
+            char* temp = lhsString;
+            lhsString = padded;
+            padded = temp;
+            memcpy(rhsString, padded, lhsDigits + 1);
+        }
+
+        Number* lhs = fromString(lhsString);
+        Number* rhs = fromString(rhsString);
+        Number* sum = add(lhs, rhs);
+        Number* difference = subtract(lhs, rhs);
+
+        for (int level = 0; level < levels; level++) {
+            //A carry out of the top is the extra digit add puts first.
+            int carry = adders[level](res + 1, lhsString, padded, lhsDigits, 0);
+            res[0] = '1';
+            res[lhsDigits + 1] = 0;
+            numberDigits(sum, expected);
+
+            if (strcmp(res + !carry, expected) != 0) {
+                printf("%s add is wrong for %s + %s\n", names[level], lhsString, rhsString);
+                exit(1);
+            }
+
+            int borrow = subtracters[level](res, lhsString, padded, lhsDigits, 0);
+            res[lhsDigits] = 0;
+            numberDigits(difference, expected);
+
+            if (borrow != 0 || strcmp(res, expected) != 0) {
+                printf("%s subtract is wrong for %s - %s\n", names[level], lhsString, rhsString);
+                exit(1);
+            }
+        }
+
+        freeNumber(lhs);
+        freeNumber(rhs);
+        freeNumber(sum);
+        freeNumber(difference);
+    }
+
+    printf("%d random pairs match add and subtract for Number\n", pairs);
+
+    //Timing each kernel on two numbers of 64 million digits, with the median of 10 runs.
+    size_t digits = 1 << 26;
+    char* x = (char*)malloc(digits);
+    char* y = (char*)malloc(digits);
+    char* out = (char*)malloc(digits);
+
+    for (size_t i = 0; i < digits; i++) {
+        x[i] = '0' + rand() % 10;
+        y[i] = '0' + rand() % 10;
+    }
+
+    memset(out, '0', digits);
+
+    KernelBenchmark operands = {NULL, out, x, y, digits};
+    char name[BENCHMARK_NAME_LENGTH];
+
+    printf("%-10s %14s %14s\n", "Kernel", "Add (GB/s)", "Subtract (GB/s)");
+
+    for (int level = 0; level < levels; level++) {
+        operands.kernel = adders[level];
+        snprintf(name, sizeof(name), "%s add", names[level]);
+        BenchmarkResult addResult = runBenchmark(name, NULL, runDigitKernel, &operands, longRunBenchmarkOptions(10));
+
+        operands.kernel = subtracters[level];
+        snprintf(name, sizeof(name), "%s subtract", names[level]);
+        BenchmarkResult subtractResult = runBenchmark(name, NULL, runDigitKernel, &operands, longRunBenchmarkOptions(10));
+
+        printf("%-10s %14.2f %14.2f\n", names[level], digits / addResult.median, digits / subtractResult.median);
+    }
+
+    free(x);
+    free(y);
+    free(out);
+    free(lhsString);
+    free(rhsString);
+    free(padded);
+    free(expected);
+    free(res);
+}
+
 int main(int argc, char const *argv[]) {
-    Number* lhs = fromString(argv[1]);
-    Number* rhs = fromString(argv[3]);
-    Number* res;
+    //Benchmark mode, with the results written as JSON if a file is given: linkedlists -b [digits] [results.json]
+    if (argc >= 2 && strcmp(argv[1], "-b") == 0) {
+        int digits = argc >= 3 ? atoi(argv[2]) : 1000000;
+
+        if (digits <= 0) {
+            printf("Please enter a positive number of digits.\n");
+            return 1;
+        }
+
+        if (!benchmark(digits, argc >= 4 ? argv[3] : NULL)) {
+            printf("Could not write the results to %s.\n", argv[3]);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    //Streaming mode: linkedlists -s lhsFile op rhsFile outFile
+    if (argc == 6 && strcmp(argv[1], "-s") == 0) {
+        if (*argv[3] != '+' && *argv[3] != '-') {
+            printf("Unknown operator '%c', please use + or - only.\n", *argv[3]);
+            return 1;
+        }
+
+        double start = seconds();
+        int64_t digits = streamAddSubtract(argv[2], *argv[3], argv[4], argv[5]);
+        double elapsed = seconds() - start;
+
+        if (digits < 0) {
+            printf("Could not compute %s %c %s: %s\n", argv[2], *argv[3], argv[4],
+                   errno == EINVAL ? "the files must hold decimal numbers" : strerror(errno));
+            return 1;
+        }
+
+        //Throughput counts the bytes read and written.
+        struct stat lhsInfo;
+        struct stat rhsInfo;
+        stat(argv[2], &lhsInfo);
+        stat(argv[4], &rhsInfo);
+        double bytes = (double)lhsInfo.st_size + rhsInfo.st_size + digits;
+
+        printf("Wrote %lld digits to %s in %.3f s (%.1f MB/s)\n", (long long)digits, argv[5], elapsed,
+               bytes / elapsed / 1e6);
+        return 0;
+    }
 
-    //Switch statement to see if its a subtraction or an addition.
+    //Verification mode: linkedlists -v [pairs]
+    if (argc >= 2 && strcmp(argv[1], "-v") == 0) {
+        verifyDigitKernels(argc >= 3 ? atoi(argv[2]) : 100000);
+        return 0;
+    }
+
+    //Threshold mode, with the results written as JSON if a file is given: linkedlists -t [results.json]
+    if ((argc == 2 || argc == 3) && strcmp(argv[1], "-t") == 0) {
+        if (!benchmarkThresholds(argc == 3 ? argv[2] : NULL)) {
+            printf("Could not write the results to %s.\n", argv[2]);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (argc != 4) {
+        printf("Usage: %s a op b with op one of + - * / %%, %s -s lhsFile op rhsFile outFile, %s -b [digits] [results.json], "
+               "%s -t [results.json] or %s -v [pairs]\n", argv[0], argv[0], argv[0], argv[0], argv[0]);
+        return 1;
+    }
+
+    BigInt* lhs = bigIntFromString(argv[1]);
+    BigInt* rhs = bigIntFromString(argv[3]);
+    BigInt* res;
+    BigInt* quotient;
+
+    if (!lhs || !rhs) {
+        printf("Please enter valid number.\n");
+        exit(1);
+    }
+
+    //Switch statement to see which operation it is.
     switch (*argv[2]) {
     case '+':
-        res = add(lhs, rhs);
+        res = bigIntAdd(lhs, rhs);
         break;
 
     case '-':
-        res = subtract(lhs, rhs);
+        res = bigIntSubtract(lhs, rhs);
+        break;
+
+    case '*':
+        res = bigIntMultiply(lhs, rhs);
+        break;
+
+    case '/':
+        res = bigIntDivide(lhs, rhs, NULL);
+        break;
+
+    case '%':
+        quotient = bigIntDivide(lhs, rhs, &res);
+        res = quotient ? res : NULL;
+        freeBigInt(quotient);
         break;
 
     default:
-        printf("Unknown operator '%c', please use + or - only.", *argv[2]);
+        printf("Unknown operator '%c', please use + - * / or %% only.\n", *argv[2]);
+        return 1;
     }
 
-    int width = max(res->length, max(lhs->length, rhs->length));
+    if (!res) {
+        printf("Division by zero.\n");
+        return 1;
+    }
+
+    int lhsWidth = (int)bigIntDigits(lhs) + lhs->negative;
+    int rhsWidth = (int)bigIntDigits(rhs) + rhs->negative;
+    int resWidth = (int)bigIntDigits(res) + res->negative;
+    int width = max(resWidth, max(lhsWidth, rhsWidth));
 
     printf("  ");
-    printNumber(lhs, width);
+    printBigInt(lhs, width);
     printf("\n%c ", *argv[2]);
-    printNumber(rhs, width);
+    printBigInt(rhs, width);
     printf("\n= ");
-    printNumber(res, width);
+    printBigInt(res, width);
     printf("\n");
 
+    freeBigInt(lhs);
+    freeBigInt(rhs);
+    freeBigInt(res);
+
     return 0;
 }
@@ -0,0 +1,200 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+// Size of the blocks a file is read in.
+#define ARENA_BLOCK_SIZE (1 << 20)
+
+// Handle to a word in a string arena: the position of the word in the arena,
+// counted in units of 4 bytes. The word tree keeps handles in 31 bits, so an
+// arena holds at most 8 GB of words, and intern aborts if it would go past
+// STRING_ARENA_MAX_HANDLE.
+typedef uint32_t WordHandle;
+
+#define STRING_ARENA_MAX_HANDLE 0x7FFFFFFFu
+
+// Method to find the FNV-1a hash of a word.
+inline uint32_t wordHash(const char *word, size_t length) {
+  uint32_t hash = 2166136261u;
+
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ (unsigned char)word[i]) * 16777619u;
+  }
+
+  return hash;
+}
+
+// Storage for interned words in one contiguous block. Every distinct word is
+// copied once into the block, after its length and hash and followed by a
+// terminating 0, and is padded to 4 bytes. The handle of a word is its
+// position, so it stays valid when the block grows, but pointers from word()
+// only stay valid until the next word is interned. A hash table of handles
+// finds a word that is already stored, so a repeated word costs no memory and
+// gets the same handle.
+class StringArena {
+  std::vector<char> bytes;
+  size_t count;
+  // Open addressing table of handles, where 0 is an empty slot (no word is at
+  // position 0, since every word comes after its length and hash). The size is
+  // a power of two and is kept at most half full.
+  std::vector<uint32_t> table;
+
+  void grow() {
+    std::vector<uint32_t> larger(this->table.empty() ? 1024 : this->table.size() * 2, 0);
+    size_t mask = larger.size() - 1;
+
+    for (uint32_t handle : this->table) {
+      if (handle) {
+        size_t slot = hash(handle) & mask;
+
+        while (larger[slot]) {
+          slot = (slot + 1) & mask;
+        }
+
+        larger[slot] = handle;
+      }
+    }
+
+    this->table.swap(larger);
+  }
+
+ public:
+  StringArena() : count(0) {}
+
+  // Method to store a word of length bytes, if it is not stored already.
+  // Returns the handle of the word, and sets isNew if it was not stored.
+  WordHandle intern(const char *word, size_t length, bool *isNew = NULL) {
+    if ((this->count + 1) * 2 > this->table.size()) {
+      grow();
+    }
+
+    uint32_t wordHashValue = wordHash(word, length);
+    size_t mask = this->table.size() - 1;
+    size_t slot = wordHashValue & mask;
+
+    // Comparing the hash and the length first, so only matching words are
+    // compared in full.
+    while (this->table[slot]) {
+      WordHandle stored = this->table[slot];
+
+      if (hash(stored) == wordHashValue && this->length(stored) == length &&
+          memcmp(this->word(stored), word, length) == 0) {
+        if (isNew) {
+          *isNew = false;
+        }
+
+        return stored;
+      }
+
+      slot = (slot + 1) & mask;
+    }
+
+    // Appending the length, the hash and the word, padded to 4 bytes.
+    size_t position = this->bytes.size();
+    size_t size = (2 * sizeof(uint32_t) + length + 1 + 3) & ~(size_t)3;
+    uint32_t header[2] = {(uint32_t)length, wordHashValue};
+
+    // A handle that does not fit in 31 bits would be cut off in the tree and
+    // point at another word, so running out of handles is fatal.
+    if ((position + sizeof(header)) / 4 > STRING_ARENA_MAX_HANDLE || length > UINT32_MAX) {
+      fprintf(stderr, "The string arena is full: words can take at most 8 GB.\n");
+      abort();
+    }
+
+    this->bytes.resize(position + size);
+    memcpy(this->bytes.data() + position, header, sizeof(header));
+    memcpy(this->bytes.data() + position + sizeof(header), word, length);
+    memset(this->bytes.data() + position + sizeof(header) + length, 0, size - sizeof(header) - length);
+
+    WordHandle handle = (WordHandle)((position + sizeof(header)) / 4);
+    this->table[slot] = handle;
+    this->count++;
+
+    if (isNew) {
+      *isNew = true;
+    }
+
+    return handle;
+  }
+
+  WordHandle intern(const char *word) { return intern(word, strlen(word)); }
+
+  const char *word(WordHandle handle) const { return this->bytes.data() + (size_t)handle * 4; }
+
+  uint32_t length(WordHandle handle) const {
+    uint32_t length;
+    memcpy(&length, word(handle) - 2 * sizeof(uint32_t), sizeof(length));
+    return length;
+  }
+
+  uint32_t hash(WordHandle handle) const {
+    uint32_t hash;
+    memcpy(&hash, word(handle) - sizeof(uint32_t), sizeof(hash));
+    return hash;
+  }
+
+  // Method to get the number of distinct words.
+  size_t size() const { return this->count; }
+
+  // Method to give back the room reserved for more words, when all the words
+  // have been interned.
+  void shrinkToFit() { this->bytes.shrink_to_fit(); }
+
+  // Method to find the number of bytes the arena has allocated.
+  size_t bytesUsed() const {
+    return this->bytes.capacity() + this->table.capacity() * sizeof(uint32_t);
+  }
+};
+
+// Method to call found(word, length) for every word in a file, where words are
+// separated by whitespace. The file is read ARENA_BLOCK_SIZE bytes at a time,
+// and the word is not terminated, so it must be copied to be kept. Returns
+// false if the file could not be read.
+template <typename Function>
+bool forEachWord(FILE *file, Function found) {
+  std::vector<char> buffer(ARENA_BLOCK_SIZE);
+  // Number of bytes at the start of the buffer that belong to a word that
+  // continues in the next block.
+  size_t carried = 0;
+
+  for (;;) {
+    if (carried == buffer.size()) {
+      buffer.resize(buffer.size() * 2);
+    }
+
+    size_t n = fread(buffer.data() + carried, 1, buffer.size() - carried, file);
+    size_t end = carried + n;
+    size_t start = 0;
+
+    for (size_t i = carried; i < end; i++) {
+      if (isspace((unsigned char)buffer[i])) {
+        if (i > start) {
+          found(buffer.data() + start, i - start);
+        }
+
+        start = i + 1;
+      }
+    }
+
+    if (n == 0) {
+      if (end > start) {
+        found(buffer.data() + start, end - start);
+      }
+
+      return !ferror(file);
+    }
+
+    // Moving the unfinished word to the start of the buffer.
+    carried = end - start;
+    memmove(buffer.data(), buffer.data() + start, carried);
+  }
+}
+
+#endif
@@ -1,8 +1,29 @@
+#include <malloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Benchmark/benchmark.h"
+#include "concurrentWordSet.h"
+#include "stringArena.h"
+#include "wordDictionary.h"
+#include "wordTree.h"
+
+// Bytes per word in the benchmark, enough for any int and the terminating 0.
+#define BENCHMARK_WORD_LENGTH 12
+// The unbalanced tree turns into a list on sorted words, so it only gets this
+// many of them in the benchmark.
+#define BST_SORTED_LIMIT 20000
+// Number of times each lookup pass of the benchmark is timed.
+#define LOOKUP_SAMPLES 10
 
 // Structure for Node.
 typedef struct NodeStruct {
@@ -53,6 +74,30 @@ void insert(Node *root, const char *word) {
   }
 }
 
+// Method to find the node with a word, or NULL if the word is not in the tree.
+Node *search(Node *root, const char *word) {
+  while (root) {
+    int compare = strcmp(word, root->word);
+
+    if (compare == 0) {
+      return root;
+    }
+
+    root = compare < 0 ? root->left : root->right;
+  }
+
+  return NULL;
+}
+
+// Method to free the nodes of a tree.
+void freeTree(Node *root) {
+  if (root) {
+    freeTree(root->left);
+    freeTree(root->right);
+    free(root);
+  }
+}
+
 // Method to print the resulting data.
 void printResult(Node *root) {
   if (root) {
@@ -100,21 +145,470 @@ void printTree(Node *root, int width) {
   }
 }
 
+// Method to print the words in a word tree in alphabetical order.
+void printResult(const WordTree &tree) {
+  for (const char *word : tree) {
+    printf("%s ", word);
+  }
+}
+
+// Method to print the words in a dictionary in alphabetical order.
+void printResult(const WordDictionary &dictionary) {
+  for (const char *word : dictionary) {
+    printf("%s ", word);
+  }
+}
+
+// Method to bulk load a dictionary with the words of a word tree. The
+// dictionary points into the tree's string arena, so no more words may be
+// interned in it while the dictionary is used.
+void loadDictionary(WordDictionary &dictionary, const WordTree &tree) {
+  std::vector<const char *> words;
+  words.reserve(tree.size());
+
+  for (const char *word : tree) {
+    words.push_back(word);
+  }
+
+  dictionary.bulkLoad(words.data(), words.size());
+}
+
+// Method to print a word tree level by level, like printTree for Node.
+void printTree(const WordTree &tree, int width) {
+  uint32_t current;
+  std::queue<uint32_t> queue;
+  std::queue<uint32_t> temp;
+  temp.push(tree.getRoot());
+  int padlen;
+  const char *toPrint;
+
+  while (!temp.empty()) {
+    queue.swap(temp);
+
+    while (!queue.empty()) {
+      current = queue.front();
+      queue.pop();
+
+      if (current != WORD_TREE_NIL) {
+        toPrint = tree.word(current);
+        temp.push(tree.left(current));
+        temp.push(tree.right(current));
+      } else {
+        toPrint = "";
+      }
+
+      padlen = (width - strlen(toPrint)) / 2;
+      printf("%*s%s%*s", padlen, "", toPrint, padlen, "");
+    }
+
+    printf("\n");
+    width = width / 2;
+  }
+}
+
+// Method to print the cache misses per word, or -1 misses as not available.
+void printCacheMisses(long long misses, int count) {
+  if (misses >= 0) {
+    printf(", %6.2f cache misses/word\n", (double)misses / count);
+  } else {
+    printf(", cache misses not available\n");
+  }
+}
+
+// Method to run a part of the benchmark once, and print the time and the
+// cache misses per word. Building a tree changes it, so it is not repeated.
+template <typename Function>
+void measure(const char *name, int count, Function run) {
+  CacheMissCounter counter;
+  auto start = std::chrono::steady_clock::now();
+  counter.start();
+  run();
+  counter.stop();
+  auto end = std::chrono::steady_clock::now();
+
+  printf("%-50s %8.1f ns/word", name,
+         std::chrono::duration<double, std::nano>(end - start).count() / count);
+  printCacheMisses(counter.count(), count);
+}
+
+// Method to time lookups with the benchmark harness, and print the median time
+// and the cache misses per word. Lookups do not change the tree, so they are
+// repeated, and the cache misses are counted over one more pass.
+template <typename Function>
+BenchmarkResult measureLookups(const char *name, int count, Function run) {
+  BenchmarkResult result =
+      runBenchmark(name, run, longRunBenchmarkOptions(LOOKUP_SAMPLES));
+  CacheMissCounter counter;
+  counter.start();
+  run();
+  counter.stop();
+
+  printf("%-50s %8.1f ns/word (95%% CI %.1f - %.1f)", name,
+         result.median / count, result.medianLow / count,
+         result.medianHigh / count);
+  printCacheMisses(counter.count(), count);
+  return result;
+}
+
+// Method to compare the malloc tree with the arena red-black tree, on words
+// inserted in random and in sorted order. The results of the lookups are added
+// to results.
+void benchmarkTrees(int count, std::vector<BenchmarkResult> &results) {
+  // The words are stored in one block, BENCHMARK_WORD_LENGTH bytes each.
+  char *randomWords = (char *)malloc((size_t)count * BENCHMARK_WORD_LENGTH);
+  char *sortedWords = (char *)malloc((size_t)count * BENCHMARK_WORD_LENGTH);
+
+  srand(1);
+
+  for (int i = 0; i < count; i++) {
+    snprintf(randomWords + (size_t)i * BENCHMARK_WORD_LENGTH,
+             BENCHMARK_WORD_LENGTH, "%09d", rand() % 1000000000);
+    snprintf(sortedWords + (size_t)i * BENCHMARK_WORD_LENGTH,
+             BENCHMARK_WORD_LENGTH, "%09d", i);
+  }
+
+  const char *streamNames[2] = {"random", "sorted"};
+  char *streams[2] = {randomWords, sortedWords};
+
+  for (int s = 0; s < 2; s++) {
+    const char *words = streams[s];
+    int n = s == 1 && count > BST_SORTED_LIMIT ? BST_SORTED_LIMIT : count;
+    char name[64];
+    Node *rootNode = NULL;
+    StringArena arena;
+    WordTree tree(arena);
+    WordDictionary dictionary;
+    std::vector<WordHandle> handles(count);
+    size_t found = 0;
+
+    // The arena tree holds interned words, so the words are interned first.
+    for (int i = 0; i < count; i++) {
+      handles[i] = arena.intern(words + (size_t)i * BENCHMARK_WORD_LENGTH);
+    }
+
+    printf("\n%s words:\n", streamNames[s]);
+
+    snprintf(name, sizeof(name), "malloc tree insert (%d words)", n);
+    measure(name, n, [&]() {
+      rootNode = newNode(words);
+
+      for (int i = 1; i < n; i++) {
+        insert(rootNode, words + (size_t)i * BENCHMARK_WORD_LENGTH);
+      }
+    });
+
+    snprintf(name, sizeof(name), "malloc tree lookup (%d %s words)", n, streamNames[s]);
+    results.push_back(measureLookups(name, n, [&]() {
+      for (int i = 0; i < n; i++) {
+        found += search(rootNode, words + (size_t)i * BENCHMARK_WORD_LENGTH) != NULL;
+      }
+    }));
+
+    snprintf(name, sizeof(name), "arena red-black tree insert (%d words)", count);
+    measure(name, count, [&]() {
+      for (int i = 0; i < count; i++) {
+        tree.insert(handles[i]);
+      }
+    });
+
+    snprintf(name, sizeof(name), "arena red-black tree lookup (%d %s words)", count, streamNames[s]);
+    results.push_back(measureLookups(name, count, [&]() {
+      for (int i = 0; i < count; i++) {
+        found += tree.contains(words + (size_t)i * BENCHMARK_WORD_LENGTH);
+      }
+    }));
+
+    snprintf(name, sizeof(name), "B+-tree dictionary bulk load (%d words)", count);
+    measure(name, count, [&]() { loadDictionary(dictionary, tree); });
+
+    snprintf(name, sizeof(name), "B+-tree dictionary lookup (%d %s words)", count, streamNames[s]);
+    results.push_back(measureLookups(name, count, [&]() {
+      for (int i = 0; i < count; i++) {
+        found += dictionary.contains(words + (size_t)i * BENCHMARK_WORD_LENGTH);
+      }
+    }));
+
+    doNotOptimize(found);
+    printf("Height of the red-black tree: %d, %zu bytes per node\n",
+           tree.height(), sizeof(WordTreeNode));
+    freeTree(rootNode);
+  }
+
+  free(randomWords);
+  free(sortedWords);
+}
+
+// Method to find the number of bytes allocated with malloc, including large
+// blocks that malloc gets directly from the operating system.
+size_t heapBytes() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+// Method to compare reading words with a malloc and strdup per word into the
+// malloc tree, with interning them in a string arena for the arena tree.
+void benchmarkIngestion(int count) {
+  // Text with count words of 3 to 12 letters, where most words are repeated.
+  std::string text;
+  srand(1);
+
+  for (int i = 0; i < count; i++) {
+    int word = rand() % (count / 4 + 1);
+    int length = 3 + word % 10;
+
+    for (int j = 0; j < length; j++) {
+      text += (char)('a' + (word >> (2 * j)) % 26 + j % 3);
+    }
+
+    text += i % 12 == 11 ? '\n' : ' ';
+  }
+
+  printf("\nreading %d words from a stream:\n", count);
+
+  Node *rootNode = NULL;
+  size_t before = heapBytes();
+  FILE *file = fmemopen((void *)text.data(), text.size(), "r");
+
+  measure("malloc + strdup per word, malloc tree", count, [&]() {
+    forEachWord(file, [&](const char *word, size_t length) {
+      char *copy = strndup(word, length);
+
+      if (!rootNode) {
+        rootNode = newNode(copy);
+      } else if (search(rootNode, copy)) {
+        free(copy);
+      } else {
+        insert(rootNode, copy);
+      }
+    });
+  });
+
+  fclose(file);
+
+  size_t distinct = 0;
+  size_t used = heapBytes() - before;
+
+  // The strings are freed with the nodes.
+  std::vector<Node *> stack;
+
+  if (rootNode) {
+    stack.push_back(rootNode);
+  }
+
+  while (!stack.empty()) {
+    Node *node = stack.back();
+    stack.pop_back();
+    distinct++;
+
+    if (node->left) {
+      stack.push_back(node->left);
+    }
+
+    if (node->right) {
+      stack.push_back(node->right);
+    }
+
+    free((void *)node->word);
+    free(node);
+  }
+
+  printf("%zu bytes on the heap, %.1f bytes per distinct word\n", used, (double)used / distinct);
+
+  before = heapBytes();
+  file = fmemopen((void *)text.data(), text.size(), "r");
+
+  {
+    StringArena arena;
+    WordTree tree(arena);
+
+    measure("string arena interning, arena tree", count, [&]() {
+      forEachWord(file, [&](const char *word, size_t length) {
+        bool isNew;
+        WordHandle handle = arena.intern(word, length, &isNew);
+
+        // A word that was interned before is already in the tree.
+        if (isNew) {
+          tree.insert(handle);
+        }
+      });
+    });
+
+    fclose(file);
+    arena.shrinkToFit();
+    tree.shrinkToFit();
+
+    size_t used = heapBytes() - before;
+    printf("%zu bytes on the heap, %.1f bytes per distinct word\n", used, (double)used / arena.size());
+  }
+}
+
+// Method to stress the concurrent word set with 1 to maxThreads writer threads
+// inserting the same words, while as many reader threads look up words. The
+// set is checked against the distinct words afterwards.
+void benchmarkConcurrentSet(int maxThreads, int count) {
+  char *words = (char *)malloc((size_t)count * BENCHMARK_WORD_LENGTH);
+
+  srand(1);
+
+  // Drawing from count values gives many duplicates, so the writers race to
+  // insert the same words.
+  for (int i = 0; i < count; i++) {
+    snprintf(words + (size_t)i * BENCHMARK_WORD_LENGTH, BENCHMARK_WORD_LENGTH,
+             "%09d", rand() % count);
+  }
+
+  std::vector<std::string> distinct;
+
+  for (int i = 0; i < count; i++) {
+    distinct.push_back(words + (size_t)i * BENCHMARK_WORD_LENGTH);
+  }
+
+  std::sort(distinct.begin(), distinct.end());
+  distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+  for (int threads = 1; threads <= maxThreads; threads++) {
+    ConcurrentWordSet set;
+    std::atomic<bool> writing(true);
+    std::atomic<long long> lookups(0);
+    std::vector<std::thread> writers;
+    std::vector<std::thread> readers;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int t = 0; t < threads; t++) {
+      // Every writer inserts every word, starting at different places.
+      writers.emplace_back([&, t]() {
+        for (int i = 0; i < count; i++) {
+          int index = (int)(((long long)i + (long long)t * count / threads) % count);
+          set.insert(words + (size_t)index * BENCHMARK_WORD_LENGTH);
+        }
+      });
+
+      readers.emplace_back([&, t]() {
+        long long done = 0;
+        size_t found = 0;
+
+        for (int i = t; writing.load(std::memory_order_relaxed); i = (i + 7919) % count) {
+          found += set.contains(words + (size_t)i * BENCHMARK_WORD_LENGTH);
+          done++;
+        }
+
+        doNotOptimize(found);
+        lookups += done;
+      });
+    }
+
+    for (std::thread &writer : writers) {
+      writer.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    writing = false;
+
+    for (std::thread &reader : readers) {
+      reader.join();
+    }
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    // Checking that every word is in the set once and in order.
+    bool correct = set.size() == (long long)distinct.size();
+    size_t i = 0;
+
+    for (const char *word : set) {
+      correct = correct && i < distinct.size() && distinct[i] == word;
+      i++;
+    }
+
+    correct = correct && i == distinct.size();
+
+    printf("%2d writers and %2d readers: %8.2f million inserts/s, %8.2f million lookups/s%s\n",
+           threads, threads, (double)threads * count / seconds / 1e6,
+           lookups / seconds / 1e6, correct ? "" : " (NOT CORRECT)");
+  }
+
+  free(words);
+}
+
 int main(int argc, char const *argv[]) {
+  // Benchmark of the trees, with the lookup results written as JSON if a
+  // file is given: trees -b [number of words] [results.json]
+  if (argc >= 2 && strcmp(argv[1], "-b") == 0) {
+    std::vector<BenchmarkResult> results;
+    benchmarkTrees(argc >= 3 ? atoi(argv[2]) : 1000000, results);
+    benchmarkIngestion(argc >= 3 ? atoi(argv[2]) : 1000000);
+
+    if (argc >= 4 && !writeBenchmarkJson(results, argv[3])) {
+      printf("Could not write the results to %s.\n", argv[3]);
+      return 1;
+    }
+
+    return 0;
+  }
+
+  // Reading the words from a file, or standard input with -: trees -f file
+  if (argc == 3 && strcmp(argv[1], "-f") == 0) {
+    FILE *file = strcmp(argv[2], "-") == 0 ? stdin : fopen(argv[2], "r");
+    StringArena arena;
+    WordTree tree(arena);
+    long long count = 0;
+
+    bool ok = file && forEachWord(file, [&](const char *word, size_t length) {
+      bool isNew;
+      WordHandle handle = arena.intern(word, length, &isNew);
+      count++;
+
+      if (isNew) {
+        tree.insert(handle);
+      }
+    });
+
+    if (!ok) {
+      printf("Could not read the words in %s.\n", argv[2]);
+      exit(1);
+    }
+
+    if (file != stdin) {
+      fclose(file);
+    }
+
+    WordDictionary dictionary;
+    loadDictionary(dictionary, tree);
+
+    printf("%lld words, %zu distinct:\n", count, tree.size());
+    printResult(dictionary);
+    printf("\n");
+
+    return 0;
+  }
+
+  // Stress test of the concurrent word set: trees -c [threads] [number of words]
+  if (argc >= 2 && strcmp(argv[1], "-c") == 0) {
+    int threads = argc >= 3 ? atoi(argv[2]) : (int)std::thread::hardware_concurrency();
+    benchmarkConcurrentSet(threads > 0 ? threads : 1, argc >= 4 ? atoi(argv[3]) : 1000000);
+    return 0;
+  }
+
   if (argc < 2) {
     printf("Please enter data to insert into the tree.\n");
     exit(1);
   }
 
-  Node *rootNode = newNode(argv[1]);
+  // The words are kept in a balanced tree, so the order they are given in
+  // does not matter.
+  StringArena arena;
+  WordTree tree(arena);
 
-  for (int i = 2; i < argc; i++) {
-    insert(rootNode, argv[i]);
+  for (int i = 1; i < argc; i++) {
+    tree.insert(arena.intern(argv[i]));
   }
 
-  printTree(rootNode, 64);
+  // The words are printed in order from a dictionary loaded from the tree.
+  WordDictionary dictionary;
+  loadDictionary(dictionary, tree);
+
+  printTree(tree, 64);
   printf("\n");
-  printResult(rootNode);
+  printResult(dictionary);
   printf("\n");
 
   return 0;
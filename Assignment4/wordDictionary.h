@@ -0,0 +1,166 @@
+#ifndef WORD_DICTIONARY_H
+#define WORD_DICTIONARY_H
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+// Number of keys in a node of the dictionary. 16 prefixes of 8 bytes fill two
+// cache lines.
+#define DICTIONARY_NODE_KEYS 16
+#define DICTIONARY_NODE_BITS 4
+
+// Structure for a node in the dictionary: the first 8 bytes of each key,
+// packed big-endian so comparing two prefixes as integers gives the same order
+// as strcmp. Unused keys are UINT64_MAX.
+typedef struct alignas(64) {
+  uint64_t prefixes[DICTIONARY_NODE_KEYS];
+} DictionaryNode;
+
+// Method to pack the first 8 bytes of a word into a prefix.
+inline uint64_t wordPrefix(const char *word) {
+  uint64_t prefix = 0;
+
+  for (int i = 0; i < 8 && word[i]; i++) {
+    prefix |= (uint64_t)(unsigned char)word[i] << (56 - 8 * i);
+  }
+
+  return prefix;
+}
+
+// Method to count the prefixes in a node that are smaller than prefix.
+inline int countSmallerPrefixes(const DictionaryNode &node, uint64_t prefix) {
+  int count = 0;
+
+  for (int i = 0; i < DICTIONARY_NODE_KEYS; i++) {
+    count += node.prefixes[i] < prefix;
+  }
+
+  return count;
+}
+
+// Method to count the smaller prefixes 4 at a time with AVX2. AVX2 only
+// compares signed numbers, so the sign bits are flipped first.
+__attribute__((target("avx2")))
+inline int countSmallerPrefixesAvx2(const DictionaryNode &node, uint64_t prefix) {
+  const __m256i bias = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+  __m256i key = _mm256_xor_si256(_mm256_set1_epi64x((long long)prefix), bias);
+  int count = 0;
+
+  for (int i = 0; i < DICTIONARY_NODE_KEYS; i += 4) {
+    __m256i values = _mm256_xor_si256(_mm256_load_si256((const __m256i *)(node.prefixes + i)), bias);
+    __m256i smaller = _mm256_cmpgt_epi64(key, values);
+    count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(smaller)));
+  }
+
+  return count;
+}
+
+// Static B+-tree of words, built once from a sorted word list and then only
+// read. The leaf level holds the prefixes of all the words in order, and each
+// level above holds the first key of every node in the level below, so the
+// children of a node are found by index and no pointers are stored. A lookup
+// reads one node of 16 prefixes per level, and only compares whole words when
+// their first 8 bytes are equal.
+class WordDictionary {
+  // The words in alphabetical order.
+  std::vector<const char *> words;
+  // levels[0] is the leaf level, and the last level is the root node.
+  std::vector<std::vector<DictionaryNode>> levels;
+  std::vector<size_t> levelSizes;
+
+  // Method to find the number of keys in a node that are at most word. Key k
+  // on level l is the word with index k * 16^l.
+  int countNotGreater(int level, size_t node, const char *word, uint64_t prefix) const {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    const DictionaryNode &keys = this->levels[level][node];
+    size_t first = node * DICTIONARY_NODE_KEYS;
+    size_t size = this->levelSizes[level] - first;
+    int count = avx2 ? countSmallerPrefixesAvx2(keys, prefix) : countSmallerPrefixes(keys, prefix);
+
+    if (size > DICTIONARY_NODE_KEYS) {
+      size = DICTIONARY_NODE_KEYS;
+    }
+
+    // Keys with the same prefix are compared in full.
+    while ((size_t)count < size && keys.prefixes[count] == prefix &&
+           strcmp(this->words[(first + count) << (DICTIONARY_NODE_BITS * level)], word) <= 0) {
+      count++;
+    }
+
+    return count;
+  }
+
+ public:
+  // Method to build the dictionary from n words in strictly increasing strcmp
+  // order, for example the words of a WordTree in order. The dictionary keeps
+  // pointers to the words, so they must live as long as it.
+  void bulkLoad(const char *const *sortedWords, size_t n) {
+    this->words.assign(sortedWords, sortedWords + n);
+    this->levels.clear();
+    this->levelSizes.clear();
+
+    size_t size = n;
+    size_t step = 1;
+
+    // Building the levels from the leaves up, until a level fits in one node.
+    do {
+      std::vector<DictionaryNode> level((size + DICTIONARY_NODE_KEYS - 1) / DICTIONARY_NODE_KEYS);
+
+      for (size_t i = 0; i < level.size() * DICTIONARY_NODE_KEYS; i++) {
+        level[i / DICTIONARY_NODE_KEYS].prefixes[i % DICTIONARY_NODE_KEYS] =
+            i < size ? wordPrefix(sortedWords[i * step]) : UINT64_MAX;
+      }
+
+      this->levels.push_back(level);
+      this->levelSizes.push_back(size);
+      size = level.size();
+      step *= DICTIONARY_NODE_KEYS;
+    } while (size > 1);
+  }
+
+  // Method to find the index of the first word that is not before word
+  // alphabetically, or size() if there is none.
+  size_t lowerBound(const char *word) const {
+    if (this->words.empty()) {
+      return 0;
+    }
+
+    uint64_t prefix = wordPrefix(word);
+    size_t node = 0;
+
+    // On every level, the last key that is at most the word leads to the node
+    // on the level below where the word would be.
+    for (int level = (int)this->levels.size() - 1; level >= 0; level--) {
+      int count = countNotGreater(level, node, word, prefix);
+
+      // Only possible in the root: the word is before every word.
+      if (count == 0) {
+        return 0;
+      }
+
+      node = node * DICTIONARY_NODE_KEYS + count - 1;
+    }
+
+    return strcmp(this->words[node], word) == 0 ? node : node + 1;
+  }
+
+  bool contains(const char *word) const {
+    size_t i = lowerBound(word);
+    return i < this->words.size() && strcmp(this->words[i], word) == 0;
+  }
+
+  size_t size() const { return this->words.size(); }
+
+  // Method to get the word with an index, in alphabetical order.
+  const char *word(size_t i) const { return this->words[i]; }
+
+  // The words in alphabetical order, for in-order traversal.
+  const char *const *begin() const { return this->words.data(); }
+
+  const char *const *end() const { return this->words.data() + this->words.size(); }
+};
+
+#endif
@@ -0,0 +1,292 @@
+#ifndef WORD_TREE_H
+#define WORD_TREE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "stringArena.h"
+
+// Index of a missing node (the NULL of the tree).
+#define WORD_TREE_NIL 0xFFFFFFFFu
+
+// Structure for a node in the word tree. The word is a handle in a string
+// arena, and the children and parent are 32-bit indexes into the node arena
+// instead of pointers, so a node is 16 bytes with no malloc header, and the
+// nodes lie next to each other in memory.
+typedef struct {
+  // Handle of the word, which StringArena keeps below 2^31.
+  uint32_t word : 31;
+  uint32_t red : 1;
+  uint32_t left;
+  uint32_t right;
+  uint32_t parent;
+} WordTreeNode;
+
+// Red-black tree of words interned in a string arena. The nodes are allocated
+// from one growing array (a bump arena), so inserting a word never calls
+// malloc unless the array is full, and the indexes stay valid when the array
+// grows. The tree stays balanced for every insertion order, so its height is at
+// most 2 * log2(n + 1).
+class WordTree {
+  const StringArena *arena;
+  std::vector<WordTreeNode> nodes;
+  uint32_t root;
+
+  void rotateLeft(uint32_t x) {
+    WordTreeNode *n = this->nodes.data();
+    uint32_t y = n[x].right;
+
+    n[x].right = n[y].left;
+    if (n[y].left != WORD_TREE_NIL) {
+      n[n[y].left].parent = x;
+    }
+
+    n[y].parent = n[x].parent;
+    if (n[x].parent == WORD_TREE_NIL) {
+      this->root = y;
+    } else if (n[n[x].parent].left == x) {
+      n[n[x].parent].left = y;
+    } else {
+      n[n[x].parent].right = y;
+    }
+
+    n[y].left = x;
+    n[x].parent = y;
+  }
+
+  void rotateRight(uint32_t x) {
+    WordTreeNode *n = this->nodes.data();
+    uint32_t y = n[x].left;
+
+    n[x].left = n[y].right;
+    if (n[y].right != WORD_TREE_NIL) {
+      n[n[y].right].parent = x;
+    }
+
+    n[y].parent = n[x].parent;
+    if (n[x].parent == WORD_TREE_NIL) {
+      this->root = y;
+    } else if (n[n[x].parent].right == x) {
+      n[n[x].parent].right = y;
+    } else {
+      n[n[x].parent].left = y;
+    }
+
+    n[y].right = x;
+    n[x].parent = y;
+  }
+
+  bool isRed(uint32_t node) const {
+    return node != WORD_TREE_NIL && this->nodes[node].red;
+  }
+
+  // Restore the red-black rules after the red node z has been inserted.
+  void fixInsert(uint32_t z) {
+    WordTreeNode *n = this->nodes.data();
+
+    while (isRed(n[z].parent)) {
+      uint32_t p = n[z].parent;
+      // The parent is red, so it is not the root and the grandparent exists.
+      uint32_t g = n[p].parent;
+
+      if (p == n[g].left) {
+        uint32_t uncle = n[g].right;
+
+        if (isRed(uncle)) {
+          // Red uncle: move the red up to the grandparent and continue there.
+          n[p].red = 0;
+          n[uncle].red = 0;
+          n[g].red = 1;
+          z = g;
+        } else {
+          // Black uncle: one or two rotations end the fixing.
+          if (z == n[p].right) {
+            z = p;
+            rotateLeft(z);
+            p = n[z].parent;
+          }
+
+          n[p].red = 0;
+          n[g].red = 1;
+          rotateRight(g);
+        }
+      } else {
+        uint32_t uncle = n[g].left;
+
+        if (isRed(uncle)) {
+          n[p].red = 0;
+          n[uncle].red = 0;
+          n[g].red = 1;
+          z = g;
+        } else {
+          if (z == n[p].left) {
+            z = p;
+            rotateRight(z);
+            p = n[z].parent;
+          }
+
+          n[p].red = 0;
+          n[g].red = 1;
+          rotateLeft(g);
+        }
+      }
+    }
+
+    n[this->root].red = 0;
+  }
+
+  int height(uint32_t node) const {
+    if (node == WORD_TREE_NIL) {
+      return 0;
+    }
+
+    int left = height(this->nodes[node].left);
+    int right = height(this->nodes[node].right);
+
+    return 1 + (left > right ? left : right);
+  }
+
+ public:
+  // In-order iterator over the words.
+  class Iterator {
+    const WordTree *tree;
+    uint32_t node;
+
+   public:
+    Iterator(const WordTree *tree, uint32_t node) : tree(tree), node(node) {}
+
+    const char *operator*() const { return this->tree->word(this->node); }
+
+    Iterator &operator++() {
+      this->node = this->tree->next(this->node);
+      return *this;
+    }
+
+    bool operator!=(const Iterator &other) const {
+      return this->node != other.node;
+    }
+  };
+
+  WordTree(const StringArena &arena) : arena(&arena), root(WORD_TREE_NIL) {}
+
+  // Method to make room for count nodes in the arena, so the arena does not
+  // have to grow while they are inserted.
+  void reserve(size_t count) { this->nodes.reserve(count); }
+
+  // Method to give back the room reserved for more nodes, when all the words
+  // have been inserted.
+  void shrinkToFit() { this->nodes.shrink_to_fit(); }
+
+  // Insert a word from the arena into the tree, without recursion. Returns
+  // false if the word was already in the tree.
+  bool insert(WordHandle handle) {
+    const char *word = this->arena->word(handle);
+    uint32_t parent = WORD_TREE_NIL;
+    uint32_t current = this->root;
+    int compare = 0;
+
+    while (current != WORD_TREE_NIL) {
+      // Interned words are equal if their handles are, so only different
+      // words are compared.
+      if (this->nodes[current].word == handle) {
+        return false;
+      }
+
+      compare = strcmp(word, this->word(current));
+      parent = current;
+      current = compare < 0 ? this->nodes[current].left : this->nodes[current].right;
+    }
+
+    uint32_t z = (uint32_t)this->nodes.size();
+    this->nodes.push_back(WordTreeNode{handle, 1, WORD_TREE_NIL, WORD_TREE_NIL, parent});
+
+    if (parent == WORD_TREE_NIL) {
+      this->root = z;
+    } else if (compare < 0) {
+      this->nodes[parent].left = z;
+    } else {
+      this->nodes[parent].right = z;
+    }
+
+    fixInsert(z);
+    return true;
+  }
+
+  // Method to find the node with a word. Returns WORD_TREE_NIL if the word is
+  // not in the tree.
+  uint32_t find(const char *word) const {
+    uint32_t current = this->root;
+
+    while (current != WORD_TREE_NIL) {
+      int compare = strcmp(word, this->word(current));
+
+      if (compare == 0) {
+        return current;
+      }
+
+      current = compare < 0 ? this->nodes[current].left : this->nodes[current].right;
+    }
+
+    return WORD_TREE_NIL;
+  }
+
+  bool contains(const char *word) const { return find(word) != WORD_TREE_NIL; }
+
+  const char *word(uint32_t node) const { return this->arena->word(this->nodes[node].word); }
+
+  WordHandle handle(uint32_t node) const { return this->nodes[node].word; }
+
+  uint32_t left(uint32_t node) const { return this->nodes[node].left; }
+
+  uint32_t right(uint32_t node) const { return this->nodes[node].right; }
+
+  uint32_t getRoot() const { return this->root; }
+
+  size_t size() const { return this->nodes.size(); }
+
+  // Method to find the number of levels in the tree.
+  int height() const { return height(this->root); }
+
+  // Method to find the node with the first word alphabetically.
+  uint32_t first() const {
+    uint32_t current = this->root;
+
+    while (current != WORD_TREE_NIL && this->nodes[current].left != WORD_TREE_NIL) {
+      current = this->nodes[current].left;
+    }
+
+    return current;
+  }
+
+  // Method to find the node with the next word alphabetically, or
+  // WORD_TREE_NIL after the last word.
+  uint32_t next(uint32_t node) const {
+    const WordTreeNode *n = this->nodes.data();
+
+    // The next word is the first word in the right subtree if there is one,
+    // otherwise the first ancestor this node is to the left of.
+    if (n[node].right != WORD_TREE_NIL) {
+      node = n[node].right;
+
+      while (n[node].left != WORD_TREE_NIL) {
+        node = n[node].left;
+      }
+
+      return node;
+    }
+
+    while (n[node].parent != WORD_TREE_NIL && n[n[node].parent].right == node) {
+      node = n[node].parent;
+    }
+
+    return n[node].parent;
+  }
+
+  Iterator begin() const { return Iterator(this, first()); }
+
+  Iterator end() const { return Iterator(this, WORD_TREE_NIL); }
+};
+
+#endif
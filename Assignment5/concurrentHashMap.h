@@ -0,0 +1,363 @@
+#ifndef CONCURRENT_HASH_MAP_H
+#define CONCURRENT_HASH_MAP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+//Number of slots copied at a time when the table grows. Threads take chunks one at a time, so they share the copy.
+#define COPY_CHUNK_SIZE 4096
+
+//Number of cache lines a shared count is split over. Each thread adds to one of them, so threads that insert at the
+//same time rarely write to the same cache line.
+#define COUNTER_STRIPES 16
+
+//An insert checks if its table is half full, which sums all the stripes of the count, when the stripe it added to
+//reaches a multiple of LOAD_CHECK_INTERVAL or its probe was at least LONG_PROBE slots long.
+#define LOAD_CHECK_INTERVAL 64
+#define LONG_PROBE 16
+
+//Count that many threads add to, split into stripes on their own cache lines.
+class StripedCounter {
+    struct alignas(64) Stripe {
+        std::atomic<size_t> value;
+    };
+
+    Stripe stripes[COUNTER_STRIPES];
+
+    //Method to get the stripe of this thread. Threads get the stripes in turn.
+    static int stripe() {
+        static std::atomic<int> nextStripe(0);
+        thread_local int index = nextStripe.fetch_add(1, std::memory_order_relaxed) % COUNTER_STRIPES;
+        return index;
+    }
+
+    public:
+    StripedCounter() {
+        for (int i = 0; i < COUNTER_STRIPES; i++) {
+            this->stripes[i].value = 0;
+        }
+    }
+
+    //Method to add to the stripe of this thread. Returns the new value of that stripe.
+    size_t add(size_t amount) {
+        return this->stripes[stripe()].value.fetch_add(amount, std::memory_order_relaxed) + amount;
+    }
+
+    //Method to sum the stripes. It is only exact when no thread is adding.
+    size_t sum() const {
+        size_t total = 0;
+
+        for (int i = 0; i < COUNTER_STRIPES; i++) {
+            total += this->stripes[i].value.load(std::memory_order_relaxed);
+        }
+
+        return total;
+    }
+};
+
+//A slot holds the key in the top 32 bits and the value in the bottom 32 bits, so it is written with one
+//compare-and-swap. Key 0 is not kept in the tables: a slot of 0 is empty (so a table from calloc is all empty), and
+//key 0 with value 1 marks an empty slot that was closed when the table was copied to a larger one.
+#define SLOT_EMPTY ((uint64_t)0)
+#define SLOT_MOVED ((uint64_t)1)
+
+//Hash map from int keys to int values that many threads can insert into and search at the same time, with linear
+//probing. A key is inserted with one compare-and-swap of an empty slot, and keys are never changed or removed after
+//that, so readers only load slots and never wait.
+//When a table is about half full a table of twice the size is added after it, and every thread that inserts copies a chunk
+//of the old table until it is done. Copying closes each empty slot with SLOT_MOVED and inserts each key into the new
+//table, but leaves the key in the old table. A probe for a key that reaches SLOT_MOVED has passed every slot the key
+//could be in, so it goes on in the next table, and a probe that reaches an empty slot knows the key is not in the map.
+//Old tables are kept until the map is destroyed, as threads can still be reading them.
+//Key 0 is kept on its own, in zeroKey, so every int can be a key like in FlatHashMap.
+class ConcurrentHashMap {
+    //The fields every insert reads come first. The fields that are written while the table grows are each on their
+    //own cache line, so the writes do not slow down the reads.
+    struct Table {
+        std::atomic<uint64_t>* slots;
+        size_t capacity;
+        std::atomic<Table*> next;
+        Table* previous;
+        alignas(64) std::atomic<bool> growing;
+        alignas(64) std::atomic<size_t> chunksClaimed;
+        alignas(64) std::atomic<size_t> chunksCopied;
+        //Number of keys inserted into this table, also the ones copied from the table before it.
+        StripedCounter count;
+    };
+
+    std::atomic<Table*> current;
+    //0 if key 0 is not in the map, otherwise its value in the bottom 32 bits and 1 in the top 32 bits.
+    std::atomic<uint64_t> zeroKey;
+    //Number of keys in the map, which is not the count of any one table while a copy is going on.
+    StripedCounter elementCount;
+
+    static Table* newTable(size_t capacity, Table* previous) {
+        Table* table = new Table();
+
+        //calloc leaves the pages of a large table untouched until they are used.
+        table->slots = (std::atomic<uint64_t>*)calloc(capacity, sizeof(uint64_t));
+        table->capacity = capacity;
+        table->next = NULL;
+        table->growing = false;
+        table->chunksClaimed = 0;
+        table->chunksCopied = 0;
+        table->previous = previous;
+
+        return table;
+    }
+
+    static uint64_t packSlot(int key, int value) {
+        return (uint64_t)(uint32_t)key << 32 | (uint32_t)value;
+    }
+
+    static int slotKey(uint64_t slot) {
+        return (int)(uint32_t)(slot >> 32);
+    }
+
+    static int slotValue(uint64_t slot) {
+        return (int)(uint32_t)slot;
+    }
+
+    //Method to find the first slot to probe for a key.
+    static size_t hash(int key, size_t capacity) {
+        uint64_t h = (uint64_t)(uint32_t)key * 0x9E3779B97F4A7C15ull;
+        return (h ^ (h >> 32)) & (capacity - 1);
+    }
+
+    //Method to add the next table, twice the size, when a table is about half full. Only one thread allocates it, the others
+    //go on inserting into the table, which still has room.
+    void grow(Table* table) {
+        bool expected = false;
+
+        if (table->next.load(std::memory_order_acquire) == NULL &&
+            table->growing.compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
+            Table* next = newTable(table->capacity * 2, table);
+            table->next.store(next, std::memory_order_release);
+        }
+    }
+
+    static size_t chunkCount(const Table* table) {
+        return (table->capacity + COPY_CHUNK_SIZE - 1) / COPY_CHUNK_SIZE;
+    }
+
+    //Method to make the first table that is not copied yet the current table.
+    void advance() {
+        Table* table = this->current.load(std::memory_order_acquire);
+        Table* next;
+
+        while ((next = table->next.load(std::memory_order_acquire)) != NULL &&
+               table->chunksCopied.load(std::memory_order_acquire) == chunkCount(table)) {
+            this->current.compare_exchange_strong(table, next, std::memory_order_acq_rel);
+            table = this->current.load(std::memory_order_acquire);
+        }
+    }
+
+    //Method to copy one chunk of a table to the next table, if there is a chunk left. The table that finishes the copy
+    //becomes the current table.
+    void copyChunk(Table* table, Table* next) {
+        size_t chunks = chunkCount(table);
+
+        //Once every chunk is taken, inserts only load the counter instead of writing to its cache line.
+        if (table->chunksClaimed.load(std::memory_order_relaxed) >= chunks) {
+            return;
+        }
+
+        size_t chunk = table->chunksClaimed.fetch_add(1, std::memory_order_relaxed);
+
+        if (chunk >= chunks) {
+            return;
+        }
+
+        size_t end = std::min(table->capacity, (chunk + 1) * COPY_CHUNK_SIZE);
+
+        for (size_t i = chunk * COPY_CHUNK_SIZE; i < end; i++) {
+            uint64_t slot = SLOT_EMPTY;
+
+            //Closing an empty slot. If a key was inserted into it first, the key is copied instead.
+            if (!table->slots[i].compare_exchange_strong(slot, SLOT_MOVED, std::memory_order_acq_rel)) {
+                insertInto(next, slotKey(slot), slotValue(slot), true);
+            }
+        }
+
+        if (table->chunksCopied.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks) {
+            advance();
+        }
+    }
+
+    //Method to insert a key into a table, or into a later table if the probe reaches a closed slot. A key copied from an
+    //old table is not counted again in the size of the map.
+    bool insertInto(Table* table, int key, int value, bool copy) {
+        uint64_t packed = packSlot(key, value);
+
+        for (;;) {
+            Table* next = table->next.load(std::memory_order_acquire);
+
+            if (next) {
+                copyChunk(table, next);
+            }
+
+            size_t mask = table->capacity - 1;
+            size_t position = hash(key, table->capacity);
+            bool moved = false;
+
+            for (size_t probes = 0; probes < table->capacity; probes++, position = (position + 1) & mask) {
+                uint64_t slot = table->slots[position].load(std::memory_order_acquire);
+
+                if (slot == SLOT_EMPTY &&
+                    table->slots[position].compare_exchange_strong(slot, packed, std::memory_order_acq_rel)) {
+                    size_t stripeCount = table->count.add(1);
+
+                    if ((stripeCount % LOAD_CHECK_INTERVAL == 0 || probes >= LONG_PROBE) &&
+                        table->count.sum() >= table->capacity / 2) {
+                        grow(table);
+                    }
+
+                    if (!copy) {
+                        this->elementCount.add(1);
+                    }
+
+                    return true;
+                }
+
+                //The slot was taken, either before the load or by another thread before the compare-and-swap.
+                if (slot == SLOT_MOVED) {
+                    moved = true;
+                    break;
+                }
+
+                if (slotKey(slot) == key) {
+                    return false;
+                }
+            }
+
+            if (!moved) {
+                grow(table);
+            }
+
+            //Going on in the next table once it is there. A probe that went through the whole table without finding an
+            //empty slot waits for it, which only happens if the thread that allocates it is stalled.
+            while ((next = table->next.load(std::memory_order_acquire)) == NULL) {
+                std::this_thread::yield();
+            }
+
+            table = next;
+        }
+    }
+
+    public:
+    //The capacity is rounded up to a power of 2.
+    ConcurrentHashMap(size_t capacity = 1024) {
+        size_t size = 16;
+
+        while (size < capacity) {
+            size *= 2;
+        }
+
+        this->current = newTable(size, NULL);
+        this->zeroKey = 0;
+    }
+
+    ~ConcurrentHashMap() {
+        Table* table = this->current.load();
+
+        while (table->next.load()) {
+            table = table->next.load();
+        }
+
+        while (table) {
+            Table* previous = table->previous;
+            free(table->slots);
+            delete table;
+            table = previous;
+        }
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    //Method to insert a key with a value. Returns false, and keeps the old value, if the key was already in the map.
+    bool insert(int key, int value) {
+        if (key == 0) {
+            uint64_t expected = 0;
+
+            if (!this->zeroKey.compare_exchange_strong(expected, packSlot(1, value), std::memory_order_acq_rel)) {
+                return false;
+            }
+
+            this->elementCount.add(1);
+            return true;
+        }
+
+        return insertInto(this->current.load(std::memory_order_acquire), key, value, false);
+    }
+
+    //Method to find the value of a key. Returns false if the key is not in the map.
+    bool find(int key, int* value) const {
+        if (key == 0) {
+            uint64_t slot = this->zeroKey.load(std::memory_order_acquire);
+
+            if (slot == 0) {
+                return false;
+            }
+
+            *value = slotValue(slot);
+            return true;
+        }
+
+        const Table* table = this->current.load(std::memory_order_acquire);
+
+        while (table) {
+            size_t mask = table->capacity - 1;
+            size_t position = hash(key, table->capacity);
+
+            for (size_t probes = 0; probes < table->capacity; probes++, position = (position + 1) & mask) {
+                uint64_t slot = table->slots[position].load(std::memory_order_acquire);
+
+                if (slot == SLOT_EMPTY) {
+                    return false;
+                }
+
+                if (slot == SLOT_MOVED) {
+                    break;
+                }
+
+                if (slotKey(slot) == key) {
+                    *value = slotValue(slot);
+                    return true;
+                }
+            }
+
+            //The probe reached a closed slot, or went through a full table without an empty slot.
+            table = table->next.load(std::memory_order_acquire);
+        }
+
+        return false;
+    }
+
+    bool contains(int key) const {
+        int value;
+        return find(key, &value);
+    }
+
+    //Method to get the number of keys in the map. It is only exact when no thread is inserting.
+    size_t size() const {
+        return this->elementCount.sum();
+    }
+
+    //Method to get the number of slots in the newest table.
+    size_t capacity() const {
+        const Table* table = this->current.load(std::memory_order_acquire);
+
+        while (table->next.load()) {
+            table = table->next.load();
+        }
+
+        return table->capacity;
+    }
+};
+
+#endif
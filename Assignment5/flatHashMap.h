@@ -0,0 +1,296 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+//Number of slots whose control bytes are compared at once. Built with AVX2 a group is one 32 byte register, otherwise
+//one 16 byte SSE2 register (or a plain loop on CPUs without SSE2).
+#if defined(__AVX2__)
+#define GROUP_SIZE 32
+#else
+#define GROUP_SIZE 16
+#endif
+
+//Control byte of a slot that has never been used. A probe stops at a group with an empty slot.
+#define CONTROL_EMPTY ((int8_t)-128)
+
+//Control byte of a slot whose key was erased. A probe goes past it, and an insert can use it again.
+#define CONTROL_DELETED ((int8_t)-2)
+
+//Value type of a FlatHashSet, which takes no space in the slots.
+struct NoValue {};
+
+//Open addressing hash map from integer keys to values, with the layout of a Swiss table.
+//Every slot has a control byte, which is CONTROL_EMPTY, CONTROL_DELETED or the low 7 bits of the hash of its key.
+//The control bytes of a group of slots are loaded into one SIMD register and compared with the 7 hash bits at once,
+//so a lookup only compares keys for about one slot in 128 that is not the one it looks for, and the group is usually
+//the only cache line it reads. The rest of the hash picks the first group, and the probe moves 1, 2, 3, ... groups
+//further, which visits every group since the number of groups is a power of 2.
+//Erased keys leave a tombstone unless their group has an empty slot, and the table is rehashed when the empty slots
+//get below 1/8 of it, to twice the size unless it was mostly tombstones. All int values, also 0, can be keys.
+template <typename Key, typename Value>
+class FlatHashMap {
+    typedef uint32_t GroupMask;
+
+    struct Slot {
+        Key key;
+        [[no_unique_address]] Value value;
+    };
+
+    int8_t* control;
+    std::vector<Slot> slots;
+    size_t slotCount;
+    size_t elementCount;
+    //Number of empty slots that can still be filled before the table is rehashed.
+    size_t growthLeft;
+
+    //Method to mix the bits of the key, so keys that differ in a few bits end up in different groups.
+    static uint64_t hash(Key key) {
+        uint64_t h = (uint64_t)key * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 32);
+    }
+
+    //Method to get the 7 bits of the hash stored in the control byte.
+    static int8_t hashControl(uint64_t h) {
+        return (int8_t)(h & 0x7F);
+    }
+
+    //Method to get a bit mask of the slots in the group whose control byte is the given byte.
+    static GroupMask matchByte(const int8_t* group, int8_t byte) {
+#if defined(__AVX2__)
+        __m256i controls = _mm256_load_si256((const __m256i*)group);
+        return (GroupMask)_mm256_movemask_epi8(_mm256_cmpeq_epi8(controls, _mm256_set1_epi8(byte)));
+#elif defined(__SSE2__)
+        __m128i controls = _mm_load_si128((const __m128i*)group);
+        return (GroupMask)_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(byte)));
+#else
+        GroupMask mask = 0;
+
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            mask |= (GroupMask)(group[i] == byte) << i;
+        }
+
+        return mask;
+#endif
+    }
+
+    //Method to get a bit mask of the slots in the group that are empty or deleted, which are the control bytes with the
+    //sign bit set.
+    static GroupMask matchFree(const int8_t* group) {
+#if defined(__AVX2__)
+        return (GroupMask)_mm256_movemask_epi8(_mm256_load_si256((const __m256i*)group));
+#elif defined(__SSE2__)
+        return (GroupMask)_mm_movemask_epi8(_mm_load_si128((const __m128i*)group));
+#else
+        GroupMask mask = 0;
+
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            mask |= (GroupMask)(group[i] < 0) << i;
+        }
+
+        return mask;
+#endif
+    }
+
+    //Method to find the slot of a key, or -1 if the key is not in the map.
+    ptrdiff_t findSlot(Key key) const {
+        if (this->slotCount == 0) {
+            return -1;
+        }
+
+        uint64_t h = hash(key);
+        size_t groupMask = this->slotCount / GROUP_SIZE - 1;
+        size_t group = (h >> 7) & groupMask;
+
+        for (size_t step = 1;; step++) {
+            const int8_t* controls = this->control + group * GROUP_SIZE;
+
+            for (GroupMask match = matchByte(controls, hashControl(h)); match; match &= match - 1) {
+                size_t slot = group * GROUP_SIZE + __builtin_ctz(match);
+
+                if (this->slots[slot].key == key) {
+                    return (ptrdiff_t)slot;
+                }
+            }
+
+            //A group with an empty slot ends the probe, since an insert would have used that slot.
+            if (matchByte(controls, CONTROL_EMPTY)) {
+                return -1;
+            }
+
+            group = (group + step) & groupMask;
+        }
+    }
+
+    //Method to find the first empty or deleted slot on the probe of a hash. There is always an empty slot, since the
+    //table is rehashed before it fills up.
+    size_t findFreeSlot(uint64_t h) const {
+        size_t groupMask = this->slotCount / GROUP_SIZE - 1;
+        size_t group = (h >> 7) & groupMask;
+
+        for (size_t step = 1;; step++) {
+            GroupMask free = matchFree(this->control + group * GROUP_SIZE);
+
+            if (free) {
+                return group * GROUP_SIZE + __builtin_ctz(free);
+            }
+
+            group = (group + step) & groupMask;
+        }
+    }
+
+    //Method to move all keys into a table with the given number of slots, which is a power of 2 and at least GROUP_SIZE.
+    //Tombstones are dropped.
+    void rehash(size_t newSlotCount) {
+        int8_t* oldControl = this->control;
+        std::vector<Slot> oldSlots = std::move(this->slots);
+        size_t oldSlotCount = this->slotCount;
+
+        this->control = new (std::align_val_t(64)) int8_t[newSlotCount];
+        memset(this->control, CONTROL_EMPTY, newSlotCount);
+        this->slots = std::vector<Slot>(newSlotCount);
+        this->slotCount = newSlotCount;
+        this->growthLeft = maxLoad(newSlotCount) - this->elementCount;
+
+        for (size_t i = 0; i < oldSlotCount; i++) {
+            if (oldControl[i] >= 0) {
+                uint64_t h = hash(oldSlots[i].key);
+                size_t slot = findFreeSlot(h);
+
+                this->control[slot] = hashControl(h);
+                this->slots[slot] = std::move(oldSlots[i]);
+            }
+        }
+
+        if (oldControl) {
+            ::operator delete[](oldControl, std::align_val_t(64));
+        }
+    }
+
+    //Method to get the most keys a table with the given number of slots holds before it is rehashed, which is 7/8.
+    static size_t maxLoad(size_t slotCount) {
+        return slotCount - slotCount / 8;
+    }
+
+    public:
+    FlatHashMap() : control(NULL), slotCount(0), elementCount(0), growthLeft(0) {}
+
+    ~FlatHashMap() {
+        if (this->control) {
+            ::operator delete[](this->control, std::align_val_t(64));
+        }
+    }
+
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+    //Method to make room for count keys, so they can be inserted without rehashing.
+    void reserve(size_t count) {
+        size_t newSlotCount = GROUP_SIZE;
+
+        while (maxLoad(newSlotCount) < count) {
+            newSlotCount *= 2;
+        }
+
+        if (newSlotCount > this->slotCount) {
+            rehash(newSlotCount);
+        }
+    }
+
+    //Method to insert a key with a value. Returns false, and keeps the old value, if the key was already in the map.
+    bool insert(Key key, Value value) {
+        if (findSlot(key) >= 0) {
+            return false;
+        }
+
+        uint64_t h = hash(key);
+        size_t slot = this->slotCount ? findFreeSlot(h) : 0;
+
+        //Only filling an empty slot uses up growth, a tombstone can always be used again.
+        if (this->slotCount == 0 || (this->growthLeft == 0 && this->control[slot] == CONTROL_EMPTY)) {
+            bool mostlyTombstones = this->elementCount + 1 <= maxLoad(this->slotCount) / 2;
+            rehash(this->slotCount == 0 ? GROUP_SIZE : (mostlyTombstones ? this->slotCount : this->slotCount * 2));
+            slot = findFreeSlot(h);
+        }
+
+        if (this->control[slot] == CONTROL_EMPTY) {
+            this->growthLeft--;
+        }
+
+        this->control[slot] = hashControl(h);
+        this->slots[slot].key = key;
+        this->slots[slot].value = std::move(value);
+        this->elementCount++;
+
+        return true;
+    }
+
+    //Method to insert a key into a map used as a set.
+    bool insert(Key key) {
+        return insert(key, Value());
+    }
+
+    //Method to get a pointer to the value of a key, or NULL if the key is not in the map.
+    Value* find(Key key) {
+        ptrdiff_t slot = findSlot(key);
+        return slot >= 0 ? &this->slots[slot].value : NULL;
+    }
+
+    bool contains(Key key) const {
+        return findSlot(key) >= 0;
+    }
+
+    //Method to erase a key. Returns false if the key was not in the map.
+    bool erase(Key key) {
+        ptrdiff_t slot = findSlot(key);
+
+        if (slot < 0) {
+            return false;
+        }
+
+        //If the group has an empty slot, no probe goes past it, and the slot can be empty again instead of a tombstone.
+        const int8_t* controls = this->control + slot / GROUP_SIZE * GROUP_SIZE;
+
+        if (matchByte(controls, CONTROL_EMPTY)) {
+            this->control[slot] = CONTROL_EMPTY;
+            this->growthLeft++;
+        } else {
+            this->control[slot] = CONTROL_DELETED;
+        }
+
+        this->slots[slot].value = Value();
+        this->elementCount--;
+
+        return true;
+    }
+
+    //Method to get the number of keys in the map.
+    size_t size() const {
+        return this->elementCount;
+    }
+
+    //Method to get the number of slots in the table.
+    size_t capacity() const {
+        return this->slotCount;
+    }
+
+    //Calculate the load factor.
+    double load_factor() const {
+        return this->slotCount ? (double) this->elementCount / (double) this->slotCount : 0;
+    }
+};
+
+//Hash set of integers, which is a FlatHashMap without values.
+template <typename Key>
+using FlatHashSet = FlatHashMap<Key, NoValue>;
+
+#endif
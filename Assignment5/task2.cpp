@@ -3,10 +3,18 @@
 #include <vector>
 #include <chrono>
 #include <unordered_map>
+#include <thread>
+
+#include "../Benchmark/benchmark.h"
+#include "concurrentHashMap.h"
+#include "flatHashMap.h"
 
 #define TABLE_CAPACITY 13000027
 #define NUM_ELEMENTS 10000000
 
+//Number of times the lookups are timed. Filling and erasing change the tables, so they are timed once.
+#define LOOKUP_SAMPLES 10
+
 //Defining the Hash Table.
 class HashTable {
     int collisions;
@@ -66,6 +74,15 @@ class HashTable {
     }
 }; 
 
+//Method to get the time in milliseconds used by work, which is run once.
+template <typename Work>
+long long time_ms(Work work) {
+    auto start = std::chrono::high_resolution_clock::now();
+    work();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
 int main(int argc, char const *argv[]) {
     //Initializing a table and a list of random numbers to fill the table.
     std::unordered_map<int, int> table;
@@ -108,5 +125,142 @@ int main(int argc, char const *argv[]) {
     std::cout << "The time used to fill the table by using the implemented HashTable methods: " << time_used_hash.count() << " ms" << std::endl;
     std::cout << "The number of collisions for the HashTable methods: " << hashtable.collision_count() << std::endl;
     std::cout << "Load factor for the HashTable methods: " << hashtable.load_factor() << std::endl;
+
+    //Filling a FlatHashMap, which starts empty and grows like the std::unordered_map.
+    FlatHashMap<int, int> flat_table;
+
+    long long time_used_flat = time_ms([&]() {
+        for (auto number : random_numbers) {
+            flat_table.insert(number, number);
+        }
+    });
+
+    double flat_load_factor = flat_table.load_factor();
+    size_t distinct_count = table.size();
+
+    //Looking up every number, and as many numbers that are not in the tables (all the numbers are positive).
+    long long found = 0;
+    long long flat_found = 0;
+
+    std::vector<BenchmarkResult> results;
+
+    results.push_back(runBenchmark("std::unordered_map lookups", [&]() {
+        found = 0;
+
+        for (auto number : random_numbers) {
+            found += table.find(number) != table.end();
+            found += table.find(-number) != table.end();
+        }
+    }, longRunBenchmarkOptions(LOOKUP_SAMPLES)));
+
+    results.push_back(runBenchmark("FlatHashMap lookups", [&]() {
+        flat_found = 0;
+
+        for (auto number : random_numbers) {
+            flat_found += flat_table.find(number) != NULL;
+            flat_found += flat_table.find(-number) != NULL;
+        }
+    }, longRunBenchmarkOptions(LOOKUP_SAMPLES)));
+
+    double time_find = results[0].median / 1e6;
+    double time_find_flat = results[1].median / 1e6;
+
+    //Erasing every number, which leaves tombstones in the FlatHashMap.
+    long long time_erase = time_ms([&]() {
+        for (auto number : random_numbers) {
+            table.erase(number);
+        }
+    });
+
+    long long time_erase_flat = time_ms([&]() {
+        for (auto number : random_numbers) {
+            flat_table.erase(number);
+        }
+    });
+
+    std::cout << "The time used to fill the table by using the FlatHashMap (" << GROUP_SIZE << " slots per group): "
+              << time_used_flat << " ms" << std::endl;
+    std::cout << "Load factor for the FlatHashMap: " << flat_load_factor << std::endl;
+    std::cout << "The time used to look up " << 2 * random_numbers.size() << " numbers, half of them missing: "
+              << time_find << " ms with the predefined method in c++, " << time_find_flat << " ms with the FlatHashMap"
+              << " (median of " << LOOKUP_SAMPLES << " runs)" << std::endl;
+    std::cout << "The time used to erase all the numbers: " << time_erase << " ms with the predefined method in c++, "
+              << time_erase_flat << " ms with the FlatHashMap" << std::endl;
+
+    if (found != flat_found || table.size() != 0 || flat_table.size() != 0) {
+        std::cout << "The FlatHashMap does not hold the same numbers as the predefined method in c++." << std::endl;
+        return 1;
+    }
+
+    //Filling a ConcurrentHashMap from 1 to max_threads threads, every thread inserting its own part of the numbers.
+    //The map starts small, so the threads also share the copying when it grows.
+    int max_threads = argc >= 2 ? atoi(argv[1]) : (int) std::thread::hardware_concurrency();
+    long long time_used_one_thread = 0;
+
+    for (int threads = 1; threads <= std::max(max_threads, 1); threads++) {
+        ConcurrentHashMap concurrent_table;
+        std::atomic<long long> concurrent_found(0);
+
+        //Method to run work(first, last) on every thread's part of the numbers.
+        auto run_threads = [&](auto work) {
+            std::vector<std::thread> workers;
+
+            for (int t = 0; t < threads; t++) {
+                size_t first = random_numbers.size() * t / threads;
+                size_t last = random_numbers.size() * (t + 1) / threads;
+                workers.emplace_back([&, first, last]() { work(first, last); });
+            }
+
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        };
+
+        long long time_used_concurrent = time_ms([&]() {
+            run_threads([&](size_t first, size_t last) {
+                for (size_t i = first; i < last; i++) {
+                    concurrent_table.insert(random_numbers[i], random_numbers[i]);
+                }
+            });
+        });
+
+        BenchmarkResult find_result = runBenchmark("ConcurrentHashMap lookups, " + std::to_string(threads) + " threads", [&]() {
+            concurrent_found = 0;
+
+            run_threads([&](size_t first, size_t last) {
+                long long thread_found = 0;
+
+                for (size_t i = first; i < last; i++) {
+                    thread_found += concurrent_table.contains(random_numbers[i]);
+                    thread_found += concurrent_table.contains(-random_numbers[i]);
+                }
+
+                concurrent_found += thread_found;
+            });
+        }, longRunBenchmarkOptions(LOOKUP_SAMPLES));
+
+        results.push_back(find_result);
+
+        if (threads == 1) {
+            time_used_one_thread = time_used_concurrent;
+        }
+
+        std::cout << "The time used to fill the ConcurrentHashMap with " << threads << " threads: " << time_used_concurrent
+                  << " ms (" << (double) time_used_one_thread / std::max(time_used_concurrent, 1LL) << " times 1 thread), "
+                  << "and to look up " << 2 * random_numbers.size() << " numbers: " << find_result.median / 1e6 << " ms"
+                  << std::endl;
+
+        if (concurrent_table.size() != distinct_count || concurrent_found != found) {
+            std::cout << "The ConcurrentHashMap does not hold the same numbers as the predefined method in c++." << std::endl;
+            return 1;
+        }
+    }
+
+    //Writing the lookup results as JSON if a filename is given: task2 threads results.json
+    if (argc >= 3 && !writeBenchmarkJson(results, argv[2])) {
+        std::cout << "Could not write the results to " << argv[2] << std::endl;
+        return 1;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,393 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __cplusplus
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//Shared micro-benchmark harness for the algorithms in the assignments.
+//A benchmark is run in batches of iterations, where the batch size is doubled during a warmup until a batch takes
+//at least minSampleTime. Each batch after the warmup gives one sample of the time per iteration, and the result
+//holds the median, percentiles and a confidence interval for the median.
+//The statistics, printing and JSON output are plain C, so C programs use the same harness. There the benchmark is a
+//function pointer with a context pointer instead of a lambda. C programs must define _POSIX_C_SOURCE before their
+//includes, for clock_gettime, and be linked with -lm.
+
+//Length of the name of a benchmark, including the terminating 0. Longer names are cut.
+#define BENCHMARK_NAME_LENGTH 128
+
+#ifdef __cplusplus
+//Method to make the compiler believe that value is used, so the calculation of it is not removed.
+template <typename T>
+inline void doNotOptimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+#endif
+
+//Method to make the compiler believe that all memory is read and written, so stores are not removed.
+static inline void clobberMemory() {
+    __asm__ __volatile__("" : : : "memory");
+}
+
+//Settings for a benchmark.
+typedef struct {
+    //Minimum time for the warmup, in seconds.
+    double warmupTime;
+    //Minimum time for each sample, in seconds.
+    double minSampleTime;
+    //Number of samples after the warmup.
+    int samples;
+} BenchmarkOptions;
+
+static inline BenchmarkOptions defaultBenchmarkOptions() {
+    BenchmarkOptions options = {0.1, 0.01, 30};
+    return options;
+}
+
+//Settings for runs that take much longer than minSampleTime, like sorting or looking up millions of elements:
+//one run of warmup, and then one run per sample.
+static inline BenchmarkOptions longRunBenchmarkOptions(int samples) {
+    BenchmarkOptions options = {0, 0, samples};
+    return options;
+}
+
+//Results of a benchmark, with all times in nanoseconds per iteration.
+typedef struct {
+    char name[BENCHMARK_NAME_LENGTH];
+    long long iterationsPerSample;
+    int samples;
+    double median;
+    double mean;
+    double standardDeviation;
+    double min;
+    double max;
+    double percentile5;
+    double percentile95;
+    //95% confidence interval for the median.
+    double medianLow;
+    double medianHigh;
+} BenchmarkResult;
+
+//Method to find a percentile (0-100) of count sorted values, interpolating between the two closest values.
+static inline double percentile(const double* sorted, int count, double p) {
+    double position = p / 100. * (count - 1);
+    int below = (int) position;
+    int above = below + 1 < count ? below + 1 : count - 1;
+
+    return sorted[below] + (position - below) * (sorted[above] - sorted[below]);
+}
+
+static inline int compareSamples(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+//Method to fill in the statistics of a result from the time per iteration of each sample. The samples are sorted.
+static inline void summarizeBenchmark(BenchmarkResult* result, double* samples, int count) {
+    qsort(samples, count, sizeof(double), compareSamples);
+
+    result->samples = count;
+    result->min = samples[0];
+    result->max = samples[count - 1];
+    result->median = percentile(samples, count, 50);
+    result->percentile5 = percentile(samples, count, 5);
+    result->percentile95 = percentile(samples, count, 95);
+
+    double sum = 0;
+
+    for (int i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+
+    result->mean = sum / count;
+
+    double squares = 0;
+
+    for (int i = 0; i < count; i++) {
+        squares += (samples[i] - result->mean) * (samples[i] - result->mean);
+    }
+
+    result->standardDeviation = count > 1 ? sqrt(squares / (count - 1)) : 0;
+
+    //The ranks n/2 -+ 1.96 * sqrt(n) / 2 bound the median with 95% confidence, without assuming a distribution.
+    double spread = 1.96 * sqrt((double) count) / 2;
+    long long low = (long long) floor(count / 2. - spread);
+    long long high = (long long) ceil(count / 2. + spread);
+    result->medianLow = samples[low > 0 ? low : 0];
+    result->medianHigh = samples[high < count - 1 ? high : count - 1];
+}
+
+#ifdef __cplusplus
+//Method to warm up and take the samples of a benchmark, where batch(iterations) runs a batch and returns the time
+//it used in nanoseconds.
+template <typename Batch>
+BenchmarkResult runBatches(const std::string& name, Batch batch, BenchmarkOptions options) {
+    typedef std::chrono::steady_clock Clock;
+    long long iterations = 1;
+    auto warmupStart = Clock::now();
+
+    //Warming up caches and branch predictors, while finding a batch size that takes at least minSampleTime.
+    for (;;) {
+        double batchTime = batch(iterations) / 1e9;
+        double warmedUp = std::chrono::duration<double>(Clock::now() - warmupStart).count();
+
+        if (batchTime >= options.minSampleTime && warmedUp >= options.warmupTime) {
+            break;
+        }
+
+        if (batchTime < options.minSampleTime) {
+            iterations *= 2;
+        }
+    }
+
+    std::vector<double> samples;
+
+    for (int sample = 0; sample < options.samples; sample++) {
+        samples.push_back(batch(iterations) / iterations);
+    }
+
+    BenchmarkResult result;
+    snprintf(result.name, sizeof(result.name), "%s", name.c_str());
+    result.iterationsPerSample = iterations;
+    summarizeBenchmark(&result, samples.data(), (int) samples.size());
+
+    return result;
+}
+
+//Method to run a benchmark, where run is called once per iteration.
+template <typename Function>
+BenchmarkResult runBenchmark(const std::string& name, Function run, BenchmarkOptions options = defaultBenchmarkOptions()) {
+    typedef std::chrono::steady_clock Clock;
+
+    return runBatches(name, [&](long long iterations) {
+        auto start = Clock::now();
+
+        for (long long i = 0; i < iterations; i++) {
+            run();
+            clobberMemory();
+        }
+
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }, options);
+}
+
+//Method to run a benchmark where setup is called before each iteration and is not timed, like copying the input
+//of a sort. The iterations are timed one at a time, so they should take much longer than reading the clock.
+template <typename Setup, typename Function>
+BenchmarkResult runBenchmarkWithSetup(const std::string& name, Setup setup, Function run,
+                                      BenchmarkOptions options = defaultBenchmarkOptions()) {
+    typedef std::chrono::steady_clock Clock;
+
+    return runBatches(name, [&](long long iterations) {
+        double used = 0;
+
+        for (long long i = 0; i < iterations; i++) {
+            setup();
+            clobberMemory();
+            auto start = Clock::now();
+            run();
+            clobberMemory();
+            used += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+
+        return used;
+    }, options);
+}
+
+//Counts the last level cache misses of this thread with a Linux perf counter.
+//Where perf counters are not available (no permission, or a virtual machine without them), count() returns -1.
+class CacheMissCounter {
+    int fd;
+
+    public:
+    CacheMissCounter() {
+        struct perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        this->fd = (int) syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+    }
+
+    ~CacheMissCounter() {
+        if (this->fd >= 0) {
+            close(this->fd);
+        }
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    //Method to reset the count and start counting.
+    void start() {
+        if (this->fd >= 0) {
+            ioctl(this->fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(this->fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    //Method to stop counting.
+    void stop() {
+        if (this->fd >= 0) {
+            ioctl(this->fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    //Method to get the number of cache misses between start() and stop(), or -1 if they can not be counted.
+    long long count() const {
+        long long value = 0;
+
+        if (this->fd < 0 || read(this->fd, &value, sizeof(value)) != sizeof(value)) {
+            return -1;
+        }
+
+        return value;
+    }
+};
+#else
+//Method to get the time of a monotonic clock in nanoseconds.
+static inline double benchmarkClock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+//Method to run a batch of iterations of a C benchmark and return the time it used in nanoseconds. Only run is timed.
+static inline double runBenchmarkBatch(void (*setup)(void*), void (*run)(void*), void* context, long long iterations) {
+    double used = 0;
+    double start = benchmarkClock();
+
+    for (long long i = 0; i < iterations; i++) {
+        if (setup) {
+            used += benchmarkClock() - start;
+            setup(context);
+            clobberMemory();
+            start = benchmarkClock();
+        }
+
+        run(context);
+        clobberMemory();
+    }
+
+    return used + benchmarkClock() - start;
+}
+
+//Method to run a benchmark from C, where run(context) is called once per iteration. If setup is not NULL,
+//setup(context) is called before each iteration and is not timed, and the iterations should take much longer than
+//reading the clock.
+static inline BenchmarkResult runBenchmark(const char* name, void (*setup)(void*), void (*run)(void*), void* context,
+                                           BenchmarkOptions options) {
+    long long iterations = 1;
+    double warmupStart = benchmarkClock();
+
+    //Warming up caches and branch predictors, while finding a batch size that takes at least minSampleTime.
+    for (;;) {
+        double batchTime = runBenchmarkBatch(setup, run, context, iterations) / 1e9;
+        double warmedUp = (benchmarkClock() - warmupStart) / 1e9;
+
+        if (batchTime >= options.minSampleTime && warmedUp >= options.warmupTime) {
+            break;
+        }
+
+        if (batchTime < options.minSampleTime) {
+            iterations *= 2;
+        }
+    }
+
+    double* samples = (double*)malloc(options.samples * sizeof(double));
+
+    for (int sample = 0; sample < options.samples; sample++) {
+        samples[sample] = runBenchmarkBatch(setup, run, context, iterations) / iterations;
+    }
+
+    BenchmarkResult result;
+    snprintf(result.name, sizeof(result.name), "%s", name);
+    result.iterationsPerSample = iterations;
+    summarizeBenchmark(&result, samples, options.samples);
+    free(samples);
+
+    return result;
+}
+#endif
+
+//Method to print the results of a benchmark.
+static inline void printBenchmark(const BenchmarkResult* result) {
+    printf("%s: median %g ns (95%% CI %g - %g ns), p5 %g ns, p95 %g ns, mean %g +- %g ns, %d samples of %lld iterations\n",
+           result->name, result->median, result->medianLow, result->medianHigh, result->percentile5,
+           result->percentile95, result->mean, result->standardDeviation, result->samples, result->iterationsPerSample);
+}
+
+//Method to write a string to a JSON file, with quotes around it.
+static inline void writeJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+
+    for (; *text; text++) {
+        if (*text == '"' || *text == '\\') {
+            fputc('\\', file);
+        }
+
+        fputc(*text, file);
+    }
+
+    fputc('"', file);
+}
+
+//Method to write the results of count benchmarks to a JSON file. Returns 0 if the file could not be written.
+static inline int writeBenchmarkJson(const BenchmarkResult* results, int count, const char* filename) {
+    FILE* file = fopen(filename, "w");
+
+    if (!file) {
+        return 0;
+    }
+
+    fprintf(file, "{\"unit\": \"ns\", \"benchmarks\": [");
+
+    for (int i = 0; i < count; i++) {
+        const BenchmarkResult* result = &results[i];
+
+        fprintf(file, "%s{\"name\": ", i ? ", " : "");
+        writeJsonString(file, result->name);
+        fprintf(file, ", \"iterations_per_sample\": %lld, \"samples\": %d, \"median\": %g, \"median_ci_low\": %g"
+                ", \"median_ci_high\": %g, \"mean\": %g, \"stddev\": %g, \"min\": %g, \"max\": %g, \"p5\": %g"
+                ", \"p95\": %g}", result->iterationsPerSample, result->samples, result->median, result->medianLow,
+                result->medianHigh, result->mean, result->standardDeviation, result->min, result->max,
+                result->percentile5, result->percentile95);
+    }
+
+    fprintf(file, "]}\n");
+    int written = !ferror(file);
+
+    return fclose(file) == 0 && written;
+}
+
+#ifdef __cplusplus
+inline void printBenchmark(const BenchmarkResult& result) {
+    printBenchmark(&result);
+}
+
+//Method to write the results of several benchmarks to a JSON file. Returns false if the file could not be written.
+inline bool writeBenchmarkJson(const std::vector<BenchmarkResult>& results, const std::string& filename) {
+    return writeBenchmarkJson(results.data(), (int) results.size(), filename.c_str()) != 0;
+}
+#endif
+
+#endif